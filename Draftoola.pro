@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT += core gui widgets svg designer opengl
+QT += core gui widgets svg designer opengl concurrent
 #QT += gui-private # add private classes
 QT += script
 #qtHaveModule(printsupport): QT += printsupport
@@ -13,14 +13,12 @@ include (skia.pri)
 
 CONFIG += c++17
 
+include (core.pri)
+
 TARGET = Draftoola
 TEMPLATE = app
 
 SOURCES += \
-    src/designer/canvasscene.cpp \
-    src/designer/canvasview.cpp \
-    src/designer/handleframe.cpp \
-    src/designer/ruler.cpp \
     src/gui/colordialog/QtColorWidgets/color_2d_slider.cpp \
     src/gui/colordialog/QtColorWidgets/color_line_edit.cpp \
     src/gui/colordialog/QtColorWidgets/color_names.cpp \
@@ -50,36 +48,10 @@ SOURCES += \
     src/gui/widgets/intelligentspinbox.cpp \
     src/gui/widgets/layoutsection.cpp \
     src/gui/widgets/popupmenu.cpp \
-    src/item/abstractitembase.cpp \
-    src/item/artboard.cpp \
-    src/item/itembase.cpp \
-    src/item/itemgroup.cpp \
-    src/item/itemoval.cpp \
-    src/item/itempolygon.cpp \
-    src/item/itemrect.cpp \
-    src/item/itemtext.cpp \
-    src/item/members/abstractitemproperty.cpp \
-    src/item/members/abstractproperty.cpp \
-    src/item/members/color.cpp \
-    src/item/members/exportlevel.cpp \
-    src/item/members/fills.cpp \
-    src/item/members/gradient.cpp \
-    src/item/members/pathprocessor.cpp \
-    src/item/members/shadow.cpp \
-    src/item/members/stroke.cpp \
     src/main.cpp \
-    src/mainwindow.cpp \
-    src/manager/qt2skia.cpp \
-    src/manager/skia2qt.cpp \
-    src/manager/stylefactory.cpp
+    src/mainwindow.cpp
 
 HEADERS  += \
-    src/common/skia_includes.h \
-    src/common/utilities.h \
-    src/designer/canvasscene.h \
-    src/designer/canvasview.h \
-    src/designer/handleframe.h \
-    src/designer/ruler.h \
     src/gui/colordialog/QtColorWidgets/color_2d_slider.hpp \
     src/gui/colordialog/QtColorWidgets/color_line_edit.hpp \
     src/gui/colordialog/QtColorWidgets/color_names.hpp \
@@ -113,27 +85,7 @@ HEADERS  += \
     src/gui/widgets/layoutsection.h \
     src/gui/widgets/layoutsegment.h \
     src/gui/widgets/popupmenu.h \
-    src/item/abstractitembase.h \
-    src/item/artboard.h \
-    src/item/itembase.h \
-    src/item/itemgroup.h \
-    src/item/itemoval.h \
-    src/item/itempolygon.h \
-    src/item/itemrect.h \
-    src/item/itemtext.h \
-    src/item/members/abstractitemproperty.h \
-    src/item/members/abstractproperty.h \
-    src/item/members/color.h \
-    src/item/members/exportlevel.h \
-    src/item/members/fills.h \
-    src/item/members/gradient.h \
-    src/item/members/pathprocessor.h \
-    src/item/members/shadow.h \
-    src/item/members/stroke.h \
-    src/mainwindow.h \
-    src/manager/qt2skia.h \
-    src/manager/skia2qt.h \
-    src/manager/stylefactory.h
+    src/mainwindow.h
 
 FORMS    += \
     src/gui/colordialog/colordialog.ui \
@@ -158,13 +110,8 @@ RESOURCES += \
 
 INCLUDEPATH += \
     $$PWD/src \
-    $$PWD/src/common \    
-    $$PWD/src/designer \
     $$PWD/src/gui \
     $$PWD/src/gui/colordialog \
     $$PWD/src/gui/colordialog/QtColorWidgets \    
     $$PWD/src/gui/tool_itemproperties \
-    $$PWD/src/gui/widgets \
-    $$PWD/src/item \
-    $$PWD/src/item/members \
-    $$PWD/src/manager
+    $$PWD/src/gui/widgets
@@ -0,0 +1,38 @@
+#-------------------------------------------------
+#
+# Draftoola micro benchmarks
+#
+#-------------------------------------------------
+
+QT += core gui widgets
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = DraftoolaBenchmark
+TEMPLATE = app
+
+include (../skia.pri)
+include (../core.pri)
+
+# enable AVX2 code paths on capable machines
+# QMAKE_CXXFLAGS += -mavx2
+
+SOURCES += \
+    blurbenchmark.cpp \
+    booleanbenchmark.cpp \
+    indexbenchmark.cpp \
+    main.cpp \
+    offsetbenchmark.cpp \
+    pathbenchmark.cpp \
+    scenebenchmark.cpp \
+    scenegenerator.cpp
+
+HEADERS += \
+    blurbenchmark.h \
+    booleanbenchmark.h \
+    indexbenchmark.h \
+    offsetbenchmark.h \
+    pathbenchmark.h \
+    scenebenchmark.h \
+    scenegenerator.h
@@ -0,0 +1,130 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "blurbenchmark.h"
+#include <blurprocessor.h>
+
+#include <QPainter>
+#include <QElapsedTimer>
+
+QT_BEGIN_NAMESPACE
+// https://code.woboq.org/qt5/qtbase/src/widgets/effects/qpixmapfilter.cpp.html
+extern Q_WIDGETS_EXPORT void qt_blurImage( QPainter *p, QImage &blurImage, qreal radius, bool quality, bool alphaOnly, int transposed = 0 );
+QT_END_NAMESPACE
+
+// minimal measuring time per sample in ms
+static const qint64 MinSampleTime = 200;
+
+/*!
+ * \brief Compares qt_blurImage against BlurProcessor for the same shadow setup ItemBase uses.
+ * Every sample renders the mask, blurs and tints it. Results are average milliseconds per shadow.
+ * \param out
+ */
+void BlurBenchmark::run(QTextStream &out)
+{
+    const QList<qreal> radii = {1, 2, 4, 8, 16, 32, 50, 64, 100};
+    const QList<qreal> lods = {1, 2, 4, 8};
+
+    QPainterPath shape;
+    shape.addRoundedRect(QRectF(0, 0, 200, 120), 12, 12);
+
+    out << "radius\tlod\tsize\tqt_blurImage [ms]\tBlurProcessor [ms]\tspeedup" << Qt::endl;
+
+    foreach(qreal lod, lods){
+        foreach(qreal radius, radii){
+
+            const QRectF rect = shape.boundingRect().adjusted(-radius, -radius, radius, radius);
+            const QSize size = (rect.size() * lod).toSize();
+            const QPainterPath path = shape.translated(-rect.topLeft());
+
+            const double qt = qtBlur(path, size, radius, lod);
+            const double draftoola = draftoolaBlur(path, size, radius, lod);
+
+            out << radius << "\t" << lod << "\t"
+                << size.width() << "x" << size.height() << "\t"
+                << QString::number(qt, 'f', 3) << "\t"
+                << QString::number(draftoola, 'f', 3) << "\t"
+                << QString::number(qt / draftoola, 'f', 2) << "x" << Qt::endl;
+        }
+    }
+}
+
+
+QImage BlurBenchmark::mask(const QPainterPath &shape, QSize size, qreal lod, QImage::Format format)
+{
+    QImage image(size, format);
+    image.fill(0);
+
+    QPainter painter(&image);
+    painter.scale(lod, lod);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.fillPath(shape, Qt::black);
+    painter.end();
+
+    return image;
+}
+
+
+double BlurBenchmark::qtBlur(const QPainterPath &shape, QSize size, qreal radius, qreal lod)
+{
+    QElapsedTimer timer;
+    int iterations = 0;
+
+    timer.start();
+    do{
+        QImage tmp = mask(shape, size, lod, QImage::Format_ARGB32_Premultiplied);
+
+        QImage blurred(tmp.size(), QImage::Format_ARGB32_Premultiplied);
+        blurred.fill(0);
+        QPainter blurPainter(&blurred);
+        qt_blurImage(&blurPainter, tmp, radius * lod, true, true);
+        blurPainter.end();
+
+        QPainter tintPainter(&blurred);
+        tintPainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+        tintPainter.fillRect(blurred.rect(), QColor(0, 0, 0, 128));
+        tintPainter.end();
+
+        ++iterations;
+    }while(timer.elapsed() < MinSampleTime);
+
+    return double(timer.nsecsElapsed()) / iterations / 1000000.0;
+}
+
+
+double BlurBenchmark::draftoolaBlur(const QPainterPath &shape, QSize size, qreal radius, qreal lod)
+{
+    QElapsedTimer timer;
+    int iterations = 0;
+
+    timer.start();
+    do{
+        QImage tmp = mask(shape, size, lod, QImage::Format_Alpha8);
+        BlurProcessor::blur(tmp, radius * lod);
+        QImage tinted = BlurProcessor::tint(tmp, QColor(0, 0, 0, 128));
+        Q_UNUSED(tinted)
+
+        ++iterations;
+    }while(timer.elapsed() < MinSampleTime);
+
+    return double(timer.nsecsElapsed()) / iterations / 1000000.0;
+}
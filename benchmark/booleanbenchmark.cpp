@@ -0,0 +1,115 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "booleanbenchmark.h"
+#include <pathprocessor.h>
+#include <skia_includes.h>
+
+#include <QElapsedTimer>
+#include <QtMath>
+
+// minimal measuring time per sample in ms
+static const qint64 MinSampleTime = 200;
+
+/*!
+ * \brief Compares chained pairwise unions with a single SkOpBuilder pass.
+ * Results are average milliseconds per union of all operands.
+ * \param out
+ */
+void BooleanBenchmark::run(QTextStream &out)
+{
+    const QList<int> sizes = {1, 2, 4, 8, 16, 32, 64};
+
+    out << "operands\tpairwise combine [ms]\tpairwise Op [ms]\tcombineMany [ms]" << Qt::endl;
+
+    foreach(int size, sizes){
+
+        const QList<SkPath> paths = operands(size);
+
+        // Op + Simplify per operand, as strokeShape() did before
+        const double pairwise = measure([&](){
+            SkPath result;
+            foreach(const SkPath &path, paths){
+                result = PathProcessor::combine(result, path, PathProcessor::Booleans::Unite);
+            }
+        });
+
+        // Op per operand without simplify
+        const double pairwiseOp = measure([&](){
+            PathProcessor::Pipeline pipeline;
+            foreach(const SkPath &path, paths){
+                pipeline.combine(path, PathProcessor::Booleans::Unite);
+            }
+        });
+
+        const double many = measure([&](){
+            PathProcessor::combineMany(paths, PathProcessor::Booleans::Unite);
+        });
+
+        out << size << "\t"
+            << QString::number(pairwise, 'f', 4) << "\t"
+            << QString::number(pairwiseOp, 'f', 4) << "\t"
+            << QString::number(many, 'f', 4) << Qt::endl;
+    }
+}
+
+
+/*!
+ * \brief Returns overlapping stroke like rings of rounded rectangles and circles, arranged on a circle.
+ */
+QList<SkPath> BooleanBenchmark::operands(int count)
+{
+    QList<SkPath> paths;
+
+    for(int i = 0; i < count; ++i){
+        const qreal angle = 2 * M_PI * i / qMax(count, 1);
+        const SkScalar x = SkDoubleToScalar(qCos(angle) * 60);
+        const SkScalar y = SkDoubleToScalar(qSin(angle) * 60);
+
+        SkPath path;
+        if(i % 2){
+            path.addRoundRect(SkRect::MakeXYWH(x - 50, y - 30, 100, 60), 12, 12);
+            path.addRoundRect(SkRect::MakeXYWH(x - 44, y - 24, 88, 48), 6, 6, SkPathDirection::kCCW);
+        }else{
+            path.addCircle(x, y, 40);
+            path.addCircle(x, y, 34, SkPathDirection::kCCW);
+        }
+        paths.append(path);
+    }
+
+    return paths;
+}
+
+
+double BooleanBenchmark::measure(const std::function<void()> &function)
+{
+    QElapsedTimer timer;
+    int iterations = 0;
+
+    timer.start();
+    do{
+        function();
+        iterations++;
+    }while(timer.elapsed() < MinSampleTime);
+
+    return timer.nsecsElapsed() / 1e6 / iterations;
+}
@@ -0,0 +1,182 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "indexbenchmark.h"
+#include <spatialindex.h>
+
+#include <QGraphicsRectItem>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+static const QRectF WorldRect(-16000, -16000, 32000, 32000);
+static const int QueryCount = 200;
+static const int MoveCount = 1000;
+
+/*!
+ * \brief Compares hit testing and viewport queries of QGraphicsScene::NoIndex, QGraphicsScene::BspTreeIndex and SpatialIndex.
+ * Item layout and queries use a fixed seed, so all candidates work on the same data. Query results are sorted by stacking order.
+ * \param out
+ */
+void IndexBenchmark::run(QTextStream &out)
+{
+    const QList<int> counts = {10000, 100000, 1000000};
+
+    out << "items\tindex\tbuild [ms]\tpoint query [ms]\tviewport query [ms]\tmove [ms]\thits" << Qt::endl;
+
+    foreach(int count, counts){
+
+        QRandomGenerator random(42);
+
+        QVector<QRectF> rects;
+        rects.reserve(count);
+        for(int i = 0; i < count; ++i){
+            rects.append(QRectF(WorldRect.left() + random.bounded(WorldRect.width()),
+                                WorldRect.top() + random.bounded(WorldRect.height()),
+                                10 + random.bounded(190.0),
+                                10 + random.bounded(190.0)));
+        }
+
+        QVector<QPointF> points;
+        QVector<QRectF> views;
+        for(int i = 0; i < QueryCount; ++i){
+            points.append(QPointF(WorldRect.left() + random.bounded(WorldRect.width()),
+                                  WorldRect.top() + random.bounded(WorldRect.height())));
+            views.append(QRectF(WorldRect.left() + random.bounded(WorldRect.width() - 1920),
+                                WorldRect.top() + random.bounded(WorldRect.height() - 1080),
+                                1920, 1080));
+        }
+
+        print(out, count, "NoIndex", sceneIndex(QGraphicsScene::NoIndex, rects, points, views));
+        print(out, count, "BspTreeIndex", sceneIndex(QGraphicsScene::BspTreeIndex, rects, points, views));
+        print(out, count, "SpatialIndex", spatialIndex(rects, points, views));
+    }
+}
+
+
+IndexBenchmark::Result IndexBenchmark::sceneIndex(QGraphicsScene::ItemIndexMethod method, const QVector<QRectF> &rects, const QVector<QPointF> &points, const QVector<QRectF> &views)
+{
+    Result result;
+    QElapsedTimer timer;
+
+    QGraphicsScene scene(WorldRect);
+    scene.setItemIndexMethod(method);
+
+    QVector<QGraphicsRectItem*> items;
+    items.reserve(rects.size());
+
+    timer.start();
+    foreach(const QRectF &rect, rects){
+        QGraphicsRectItem *item = new QGraphicsRectItem(QRectF(QPointF(), rect.size()));
+        item->setPos(rect.topLeft());
+        scene.addItem(item);
+        items.append(item);
+    }
+    // BSP tree is built lazily with the first query
+    scene.items(QPointF());
+    result.build = timer.nsecsElapsed() / 1e6;
+
+    timer.start();
+    foreach(const QPointF &point, points){
+        result.found += scene.items(point, Qt::IntersectsItemBoundingRect, Qt::DescendingOrder).size();
+    }
+    result.pointQuery = timer.nsecsElapsed() / 1e6 / points.size();
+
+    timer.start();
+    foreach(const QRectF &view, views){
+        result.found += scene.items(view, Qt::IntersectsItemBoundingRect, Qt::DescendingOrder).size();
+    }
+    result.rectQuery = timer.nsecsElapsed() / 1e6 / views.size();
+
+    timer.start();
+    for(int i = 0; i < MoveCount; ++i){
+        QGraphicsRectItem *item = items.at(i % items.size());
+        item->moveBy(50, 50);
+        scene.items(item->pos()); // index update is deferred until the next query
+    }
+    result.move = timer.nsecsElapsed() / 1e6;
+
+    return result;
+}
+
+
+IndexBenchmark::Result IndexBenchmark::spatialIndex(const QVector<QRectF> &rects, const QVector<QPointF> &points, const QVector<QRectF> &views)
+{
+    Result result;
+    QElapsedTimer timer;
+
+    // items are only used as keys and for sorting
+    QVector<QGraphicsRectItem*> items;
+    items.reserve(rects.size());
+    foreach(const QRectF &rect, rects){
+        QGraphicsRectItem *item = new QGraphicsRectItem(QRectF(QPointF(), rect.size()));
+        item->setPos(rect.topLeft());
+        items.append(item);
+    }
+
+    SpatialIndex index(WorldRect);
+
+    timer.start();
+    for(int i = 0; i < items.size(); ++i){
+        index.insert(items.at(i), rects.at(i));
+    }
+    result.build = timer.nsecsElapsed() / 1e6;
+
+    timer.start();
+    foreach(const QPointF &point, points){
+        QList<QGraphicsItem*> list = index.items(point);
+        index.sortByStackingOrder(list, Qt::DescendingOrder);
+        result.found += list.size();
+    }
+    result.pointQuery = timer.nsecsElapsed() / 1e6 / points.size();
+
+    timer.start();
+    foreach(const QRectF &view, views){
+        QList<QGraphicsItem*> list = index.items(view);
+        index.sortByStackingOrder(list, Qt::DescendingOrder);
+        result.found += list.size();
+    }
+    result.rectQuery = timer.nsecsElapsed() / 1e6 / views.size();
+
+    timer.start();
+    for(int i = 0; i < MoveCount; ++i){
+        QGraphicsRectItem *item = items.at(i % items.size());
+        item->moveBy(50, 50);
+        index.update(item, item->sceneBoundingRect());
+        index.items(item->pos());
+    }
+    result.move = timer.nsecsElapsed() / 1e6;
+
+    qDeleteAll(items);
+
+    return result;
+}
+
+
+void IndexBenchmark::print(QTextStream &out, int count, const QString &name, const Result &result)
+{
+    out << count << "\t" << name << "\t"
+        << QString::number(result.build, 'f', 1) << "\t"
+        << QString::number(result.pointQuery, 'f', 4) << "\t"
+        << QString::number(result.rectQuery, 'f', 4) << "\t"
+        << QString::number(result.move, 'f', 1) << "\t"
+        << result.found << Qt::endl;
+}
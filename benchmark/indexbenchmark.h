@@ -0,0 +1,53 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef INDEXBENCHMARK_H
+#define INDEXBENCHMARK_H
+
+#include <QTextStream>
+#include <QGraphicsScene>
+#include <QVector>
+#include <QRectF>
+
+class IndexBenchmark
+{
+public:
+
+    static void run(QTextStream &out);
+
+private:
+
+    struct Result {
+        double build = 0;
+        double pointQuery = 0;
+        double rectQuery = 0;
+        double move = 0;
+        qint64 found = 0;
+    };
+
+    static Result sceneIndex(QGraphicsScene::ItemIndexMethod method, const QVector<QRectF> &rects, const QVector<QPointF> &points, const QVector<QRectF> &views);
+    static Result spatialIndex(const QVector<QRectF> &rects, const QVector<QPointF> &points, const QVector<QRectF> &views);
+    static void print(QTextStream &out, int count, const QString &name, const Result &result);
+
+};
+
+#endif // INDEXBENCHMARK_H
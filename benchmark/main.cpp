@@ -0,0 +1,118 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "blurbenchmark.h"
+#include "booleanbenchmark.h"
+#include "indexbenchmark.h"
+#include "offsetbenchmark.h"
+#include "pathbenchmark.h"
+#include "scenebenchmark.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QStringList>
+
+int main(int argc, char *argv[])
+{
+    // benchmarks don't need a display
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Draftoola benchmarks");
+    parser.addHelpOption();
+    parser.addPositionalArgument("benchmarks", "blur, index, path, boolean, offset, scene. Runs all if empty.");
+
+    QCommandLineOption jsonOption("json", "Write scene benchmark results as JSON to <file>.", "file");
+    QCommandLineOption artboardsOption("artboards", "Number of generated artboards.", "count", "10");
+    QCommandLineOption itemsOption("items", "Number of generated items per artboard.", "count", "50");
+    QCommandLineOption seedOption("seed", "Seed of the scene generator.", "seed", "42");
+    parser.addOptions({jsonOption, artboardsOption, itemsOption, seedOption});
+    parser.process(a);
+
+    QTextStream out(stdout);
+    const QStringList args = parser.positionalArguments();
+    const bool all = args.isEmpty();
+
+    if(all || args.contains("blur")){
+        out << "# Shadow blur" << Qt::endl;
+        BlurBenchmark::run(out);
+        out << Qt::endl;
+    }
+
+    if(all || args.contains("index")){
+        out << "# Spatial index" << Qt::endl;
+        IndexBenchmark::run(out);
+        out << Qt::endl;
+    }
+
+    if(all || args.contains("path")){
+        out << "# Path conversion" << Qt::endl;
+        PathBenchmark::run(out);
+        out << Qt::endl;
+    }
+
+    if(all || args.contains("boolean")){
+        out << "# Boolean operations" << Qt::endl;
+        BooleanBenchmark::run(out);
+        out << Qt::endl;
+    }
+
+    if(all || args.contains("offset")){
+        out << "# Path offset" << Qt::endl;
+        OffsetBenchmark::run(out);
+        out << Qt::endl;
+    }
+
+    if(all || args.contains("scene")){
+        out << "# Scene" << Qt::endl;
+
+        SceneGenerator::Options options;
+        options.artboards = parser.value(artboardsOption).toInt();
+        options.items = parser.value(itemsOption).toInt();
+        options.seed = parser.value(seedOption).toUInt();
+
+        QJsonObject scene = SceneBenchmark::run(out, options);
+        out << Qt::endl;
+
+        if(parser.isSet(jsonOption)){
+            QJsonObject json;
+            json["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+            json["qt"] = QString(qVersion());
+            json["scene"] = scene;
+
+            QFile file(parser.value(jsonOption));
+            if(!file.open(QIODevice::WriteOnly)){
+                out << "Can't write " << file.fileName() << Qt::endl;
+                return 1;
+            }
+            file.write(QJsonDocument(json).toJson());
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "offsetbenchmark.h"
+#include <offsetprocessor.h>
+#include <pathprocessor.h>
+#include <qt2skia.h>
+#include <skia2qt.h>
+
+#include <QElapsedTimer>
+#include <QPainterPathStroker>
+#include <QtMath>
+
+// minimal measuring time per sample in ms
+static const qint64 MinSampleTime = 200;
+
+/*!
+ * \brief Compares stroke + boolean offsetting with the offset engine for spread (grow) and inset (shrink).
+ * Results are average milliseconds per offset, including conversion from and to QPainterPath.
+ * \param out
+ */
+void OffsetBenchmark::run(QTextStream &out)
+{
+    const QRectF rect(0, 0, 200, 120);
+
+    QPainterPath rectPath;
+    rectPath.addRect(rect);
+
+    QPainterPath roundedPath;
+    roundedPath.addRoundedRect(rect, 16, 16);
+
+    QPainterPath ellipsePath;
+    ellipsePath.addEllipse(rect);
+
+    QPainterPath starPath;
+    for(int i = 0; i < 64; ++i){
+        const qreal angle = 2 * M_PI * i / 64;
+        const qreal radius = (i % 2) ? 100 : 60;
+        const QPointF point(qCos(angle) * radius, qSin(angle) * radius);
+        if(i == 0) starPath.moveTo(point);
+        else starPath.lineTo(point);
+    }
+    starPath.closeSubpath();
+
+    QPainterPath blobPath;
+    blobPath.addEllipse(rect);
+    blobPath.addEllipse(rect.translated(80, 40));
+    blobPath = blobPath.simplified();
+
+    struct Primitive {
+        QString name;
+        QPainterPath path;
+        SkRRect rrect;
+        bool analytic;
+    };
+
+    const QList<Primitive> shapes = {
+        {"rect", rectPath, SkRRect::MakeRect(skia::skRect(rect)), true},
+        {"rounded rect", roundedPath, SkRRect::MakeRectXY(skia::skRect(rect), 16, 16), true},
+        {"ellipse", ellipsePath, SkRRect::MakeOval(skia::skRect(rect)), true},
+        {"star polygon", starPath, SkRRect(), false},
+        {"curved union", blobPath, SkRRect(), false}
+    };
+
+    const QList<qreal> distances = {8, -8};
+
+    out << "shape\tdistance\tstroke + Op [ms]\toffset engine [ms]" << Qt::endl;
+
+    foreach(const Primitive &shape, shapes){
+        foreach(qreal distance, distances){
+
+            const double legacy = measure([&](){ strokeOffset(shape.path, distance); });
+
+            const double engine = shape.analytic
+                    ? measure([&](){ skia::qtPath(OffsetProcessor::offset(shape.rrect, distance)); })
+                    : measure([&](){ OffsetProcessor::offset(shape.path, distance); });
+
+            out << shape.name << "\t"
+                << distance << "\t"
+                << QString::number(legacy, 'f', 4) << "\t"
+                << QString::number(engine, 'f', 4) << Qt::endl;
+        }
+    }
+}
+
+
+/*!
+ * \brief Offsetting as it was done before the offset engine.
+ */
+QPainterPath OffsetBenchmark::strokeOffset(const QPainterPath &path, qreal distance)
+{
+    QPainterPathStroker stroker;
+    stroker.setJoinStyle(Qt::MiterJoin);
+    stroker.setWidth(qAbs(distance) * 2);
+
+    const QPainterPath outline = stroker.createStroke(path);
+
+    return PathProcessor::combine(path, outline, (distance > 0) ? PathProcessor::Booleans::Unite : PathProcessor::Booleans::Subtract);
+}
+
+
+double OffsetBenchmark::measure(const std::function<void()> &function)
+{
+    QElapsedTimer timer;
+    int iterations = 0;
+
+    timer.start();
+    do{
+        function();
+        iterations++;
+    }while(timer.elapsed() < MinSampleTime);
+
+    return timer.nsecsElapsed() / 1e6 / iterations;
+}
@@ -0,0 +1,181 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "pathbenchmark.h"
+#include <qt2skia.h>
+#include <skia2qt.h>
+#include <skia_includes.h>
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <vector>
+
+// minimal measuring time per sample in ms
+static const qint64 MinSampleTime = 200;
+
+/*!
+ * \brief Compares the element wise path converters with the bulk converters, with and without conversion cache.
+ * Results are average milliseconds per conversion.
+ * \param out
+ */
+void PathBenchmark::run(QTextStream &out)
+{
+    const QList<int> sizes = {10, 100, 1000, 10000, 100000};
+
+    out << "elements\tskPath legacy [ms]\tskPath bulk [ms]\tskPath cached [ms]\tqtPath legacy [ms]\tqtPath bulk [ms]" << Qt::endl;
+
+    foreach(int size, sizes){
+
+        const QPainterPath path = shape(size);
+        const SkPath skpath = skia::skPath(path);
+
+        const double skLegacy = measure([&](){ legacySkPath(path); });
+        const double skBulk = measure([&](){ skia::clearPathCache(); skia::skPath(path); });
+        skia::skPath(path);
+        const double skCached = measure([&](){ skia::skPath(path); });
+        const double qtLegacy = measure([&](){ legacyQtPath(skpath); });
+        const double qtBulk = measure([&](){ skia::qtPath(skpath); });
+
+        out << path.elementCount() << "\t"
+            << QString::number(skLegacy, 'f', 4) << "\t"
+            << QString::number(skBulk, 'f', 4) << "\t"
+            << QString::number(skCached, 'f', 4) << "\t"
+            << QString::number(qtLegacy, 'f', 4) << "\t"
+            << QString::number(qtBulk, 'f', 4) << Qt::endl;
+    }
+
+    skia::clearPathCache();
+}
+
+
+/*!
+ * \brief Returns a closed star shape of lines and cubics with about the given number of elements.
+ */
+QPainterPath PathBenchmark::shape(int elements)
+{
+    QRandomGenerator random(7);
+    QPainterPath path;
+
+    // a cubic adds 3 elements, a line 1
+    const int segments = qMax(3, elements / 2);
+
+    for(int i = 0; i < segments && path.elementCount() < elements; ++i){
+        qreal angle = 2 * M_PI * i / segments;
+        qreal radius = (i % 2) ? 100 : 50 + random.bounded(50.0);
+        QPointF point(qCos(angle) * radius, qSin(angle) * radius);
+
+        if(i == 0) path.moveTo(point);
+        else if(i % 3 == 0) path.cubicTo(path.currentPosition() + QPointF(5, 5), point - QPointF(5, 5), point);
+        else path.lineTo(point);
+    }
+
+    path.closeSubpath();
+    return path;
+}
+
+
+double PathBenchmark::measure(const std::function<void()> &function)
+{
+    QElapsedTimer timer;
+    int iterations = 0;
+
+    timer.start();
+    do{
+        function();
+        iterations++;
+    }while(timer.elapsed() < MinSampleTime);
+
+    return timer.nsecsElapsed() / 1e6 / iterations;
+}
+
+
+/*!
+ * \brief Element wise conversion as it was done before the bulk converter.
+ */
+SkPath PathBenchmark::legacySkPath(const QPainterPath &qpath)
+{
+    SkPath path;
+    int count = qpath.elementCount();
+    for(int i = 0; i < count; i++){
+        QPainterPath::Element elem = qpath.elementAt(i);
+        switch(elem.type){
+        case QPainterPath::MoveToElement:
+            path.moveTo(skia::skPoint(elem));
+            break;
+        case QPainterPath::LineToElement:
+            path.lineTo(skia::skPoint(elem));
+            break;
+        case QPainterPath::CurveToElement:
+            path.cubicTo(skia::skPoint(elem), skia::skPoint(qpath.elementAt(i+1)), skia::skPoint(qpath.elementAt(i+2)));
+            break;
+        default:
+            break;
+        }
+    }
+
+    path.setFillType((SkPathFillType)skia::skFillRule(qpath.fillRule()));
+    return path;
+}
+
+
+/*!
+ * \brief Indexed conversion as it was done before the bulk converter.
+ */
+QPainterPath PathBenchmark::legacyQtPath(const SkPath &skpath)
+{
+    QPainterPath path;
+    int max = skpath.countVerbs();
+    std::vector<uint8_t> verbs(static_cast<size_t>(max));
+    skpath.getVerbs(verbs.data(), max);
+
+    int count = 0;
+
+    for(int i = 0; i < max; ++i){
+        switch(verbs[static_cast<size_t>(i)]){
+        case 0: // move
+            path.moveTo(skia::qtPoint(skpath.getPoint(count)));
+            count += 1;
+            break;
+        case 1: // line
+            path.lineTo(skia::qtPoint(skpath.getPoint(count)));
+            count += 1;
+            break;
+        case 2: // quad
+            path.quadTo(skia::qtPoint(skpath.getPoint(count)), skia::qtPoint(skpath.getPoint(count+1)));
+            count += 2;
+            break;
+        case 3: // conic
+            count += 3;
+            break;
+        case 4: // cubic
+            path.cubicTo(skia::qtPoint(skpath.getPoint(count)), skia::qtPoint(skpath.getPoint(count+1)), skia::qtPoint(skpath.getPoint(count+2)));
+            count += 3;
+            break;
+        default:
+            break;
+        }
+    }
+
+    path.setFillRule((Qt::FillRule)skia::qtFillRule((int)skpath.getFillType()));
+    return path;
+}
@@ -0,0 +1,203 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "scenebenchmark.h"
+
+#include <artboard.h>
+#include <canvasscene.h>
+#include <itembase.h>
+#include <pathprocessor.h>
+#include <exportengine.h>
+
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+// minimal measuring time per sample in ms
+static const qint64 MinSampleTime = 200;
+static const int QueryCount = 1000;
+
+/*!
+ * \brief Generates a synthetic document and times geometry, offscreen rendering, path operations, exports and hit tests.
+ * Rendering goes through AbstractItemBase::render() like the ExportEngine does, so no view is involved.
+ * \param out human readable table
+ * \param options document parameters
+ * \return results as JSON object, times in milliseconds
+ */
+QJsonObject SceneBenchmark::run(QTextStream &out, const SceneGenerator::Options &options)
+{
+    CanvasScene scene;
+    SceneGenerator generator(options);
+
+    QElapsedTimer timer;
+    timer.start();
+    const QList<Artboard*> artboards = generator.populate(&scene);
+    const double generate = timer.nsecsElapsed() / 1e6;
+
+    QList<AbstractItemBase*> items;
+    QList<AbstractItemBase*> artboardItems;
+    foreach(Artboard *artboard, artboards){
+        items.append(artboard->childItems());
+        artboardItems.append(artboard);
+    }
+
+    // geometry of all items from scratch
+    const double geometry = measure([&](){
+        foreach(AbstractItemBase *item, items){
+            item->invalidate(AbstractItemBase::InvalidateAll);
+            item->ensureGeometry();
+        }
+    });
+
+    // offscreen render of every artboard at 1x
+    const double render = measure([&](){
+        foreach(Artboard *artboard, artboards){
+            QImage image(artboard->renderRect().size().toSize(), QImage::Format_ARGB32_Premultiplied);
+            image.fill(Qt::transparent);
+            QPainter painter(&image);
+            painter.translate(-artboard->renderRect().topLeft());
+            artboard->render(&painter);
+        }
+    });
+
+    // union of all item outlines per artboard
+    QList<QList<QPainterPath>> shapes;
+    foreach(Artboard *artboard, artboards){
+        QList<QPainterPath> paths;
+        foreach(AbstractItemBase *item, artboard->childItems()){
+            paths.append(item->mapToParent(item->shape()));
+        }
+        shapes.append(paths);
+    }
+
+    const double pathOps = measure([&](){
+        foreach(const QList<QPainterPath> &paths, shapes){
+            PathProcessor::combineMany(paths, PathProcessor::Booleans::Unite);
+        }
+    });
+
+    // export of every artboard for all its export levels through the export engine
+    QTemporaryDir exportDir;
+    ExportEngine engine;
+    engine.setOutputDirectory(exportDir.path());
+    engine.setIncremental(false);
+
+    int exportFiles = 0;
+    QObject::connect(&engine, &ExportEngine::itemExported, [&](const ExportEngine::Result &result){
+        exportFiles += result.files.count();
+    });
+
+    const double exports = measure([&](){
+        exportFiles = 0;
+        engine.exportItems(artboardItems);
+        engine.waitForFinished();
+    });
+
+    // unchanged document, every output is found in the manifest
+    engine.setIncremental(true);
+    const double incrementalExports = measure([&](){
+        engine.exportItems(artboardItems);
+        engine.waitForFinished();
+    });
+
+    // point queries spread over the whole document
+    QRandomGenerator random(options.seed);
+    const QRectF documentRect = scene.itemsBoundingRect();
+    QVector<QPointF> points;
+    for(int i = 0; i < QueryCount; ++i){
+        points.append(QPointF(documentRect.left() + random.bounded(documentRect.width()),
+                              documentRect.top() + random.bounded(documentRect.height())));
+    }
+
+    int hits = 0;
+    const double hitTest = measure([&](){
+        hits = 0;
+        foreach(const QPointF &point, points){
+            hits += scene.indexedItems(point).count();
+        }
+    });
+
+    const double hitTestScene = measure([&](){
+        foreach(const QPointF &point, points){
+            scene.items(point, Qt::IntersectsItemShape, Qt::DescendingOrder);
+        }
+    });
+
+    out << "artboards\titems\tgenerate [ms]\tgeometry [ms]\trender [ms]\tpath ops [ms]\texport [ms]\tincremental export [ms]\thit test [ms]\tscene hit test [ms]" << Qt::endl;
+    out << artboards.count() << "\t"
+        << items.count() << "\t"
+        << QString::number(generate, 'f', 4) << "\t"
+        << QString::number(geometry, 'f', 4) << "\t"
+        << QString::number(render, 'f', 4) << "\t"
+        << QString::number(pathOps, 'f', 4) << "\t"
+        << QString::number(exports, 'f', 4) << "\t"
+        << QString::number(incrementalExports, 'f', 4) << "\t"
+        << QString::number(hitTest, 'f', 4) << "\t"
+        << QString::number(hitTestScene, 'f', 4) << Qt::endl;
+
+    QJsonObject parameters;
+    parameters["artboards"] = options.artboards;
+    parameters["items"] = options.items;
+    parameters["shadows"] = options.shadows;
+    parameters["strokes"] = options.strokes;
+    parameters["gradients"] = options.gradients;
+    parameters["images"] = options.images;
+    parameters["texts"] = options.texts;
+    parameters["seed"] = static_cast<qint64>(options.seed);
+
+    QJsonObject results;
+    results["generate"] = generate;
+    results["geometry"] = geometry;
+    results["render"] = render;
+    results["pathOps"] = pathOps;
+    results["export"] = exports;
+    results["exportFiles"] = exportFiles;
+    results["exportIncremental"] = incrementalExports;
+    results["hitTest"] = hitTest;
+    results["hitTestScene"] = hitTestScene;
+    results["hitTestQueries"] = QueryCount;
+    results["hits"] = hits;
+
+    QJsonObject json;
+    json["options"] = parameters;
+    json["itemCount"] = items.count();
+    json["results"] = results;
+
+    return json;
+}
+
+
+double SceneBenchmark::measure(const std::function<void()> &function)
+{
+    QElapsedTimer timer;
+    int iterations = 0;
+
+    timer.start();
+    do{
+        function();
+        iterations++;
+    }while(timer.elapsed() < MinSampleTime);
+
+    return timer.nsecsElapsed() / 1e6 / iterations;
+}
@@ -0,0 +1,200 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "scenegenerator.h"
+
+#include <artboard.h>
+#include <canvasscene.h>
+#include <itemoval.h>
+#include <itempolygon.h>
+#include <itemrect.h>
+#include <itemtext.h>
+
+#include <QImage>
+#include <QLinearGradient>
+#include <QPainter>
+#include <QRadialGradient>
+#include <QtMath>
+
+// space between generated artboards
+static const qreal ArtboardSpacing = 100;
+
+/***************************************************
+ *
+ * Constructor
+ *
+ ***************************************************/
+
+SceneGenerator::SceneGenerator(const Options &options) : m_options(options), m_random(options.seed){}
+
+/***************************************************
+ *
+ * Public
+ *
+ ***************************************************/
+
+/*!
+ * \brief Adds the configured number of artboards and items to the scene.
+ * Artboards are arranged in a square grid, items are placed randomly inside their artboard.
+ * \param scene
+ * \return generated artboards
+ */
+QList<Artboard *> SceneGenerator::populate(CanvasScene *scene)
+{
+    QList<Artboard*> artboards;
+
+    const int columns = qMax(1, qCeil(qSqrt(m_options.artboards)));
+
+    for(int a = 0; a < m_options.artboards; ++a){
+
+        Artboard *artboard = new Artboard("Artboard " + QString::number(a));
+        artboard->addExportLevel(ExportLevel(0, 1));
+        artboard->addExportLevel(ExportLevel(1, 2));
+        scene->addItem(artboard);
+
+        const QRectF frame = artboard->rect();
+        artboard->setPos((a % columns) * (frame.width() + ArtboardSpacing),
+                         (a / columns) * (frame.height() + ArtboardSpacing));
+
+        for(int i = 0; i < m_options.items; ++i){
+            AbstractItemBase *item = createItem(i, frame.size());
+            artboard->addItem(item);
+            item->setPos(m_random.bounded(qMax(0.0, frame.width() - item->rect().width())),
+                         m_random.bounded(qMax(0.0, frame.height() - item->rect().height())));
+        }
+
+        artboards.append(artboard);
+    }
+
+    return artboards;
+}
+
+
+SceneGenerator::Options SceneGenerator::options() const
+{
+    return m_options;
+}
+
+/***************************************************
+ *
+ * Private
+ *
+ ***************************************************/
+
+/*!
+ * \brief Creates a rect, oval, polygon, star or text item and styles it according to the option ratios.
+ */
+AbstractItemBase *SceneGenerator::createItem(int index, const QSizeF &bounds)
+{
+    const QString name = "Item " + QString::number(index);
+
+    if(chance(m_options.texts)){
+        ItemText *text = new ItemText("Lorem ipsum dolor<br>sit amet " + QString::number(index));
+        text->setName(name);
+        return text;
+    }
+
+    const qreal width = 20 + m_random.bounded(qMax(1.0, bounds.width() / 3 - 20));
+    const qreal height = 20 + m_random.bounded(qMax(1.0, bounds.height() / 4 - 20));
+
+    ItemBase *item = nullptr;
+
+    switch(m_random.bounded(4)){
+    case 0:{
+        ItemRect *rect = new ItemRect(width, height);
+        rect->setRadius(m_random.bounded(12));
+        item = rect;
+        break;
+    }
+    case 1:
+        item = new ItemOval(width, height);
+        break;
+    case 2:
+        item = new ItemPolygon(width, height, 3 + m_random.bounded(6));
+        break;
+    default:{
+        ItemPolygon *star = new ItemPolygon(width, height, 5, true);
+        star->setInnerRadius(0.5);
+        item = star;
+        break;
+    }
+    }
+
+    item->setName(name);
+
+    const Color color(m_random.bounded(256), m_random.bounded(256), m_random.bounded(256));
+
+    if(chance(m_options.images)){
+        item->addFills(Fills("image", imagePath()));
+    }else if(chance(m_options.gradients)){
+        QLinearGradient lGradient(0, 0, width, height);
+        lGradient.setColorAt(0, Qt::white);
+        lGradient.setColorAt(1, color);
+        item->addFills(Fills("gradient", Gradient("gradient", lGradient)));
+    }else{
+        item->addFills(Fills("color", color));
+    }
+
+    if(chance(m_options.strokes)){
+        const Stroke::StrokePosition positions[] = {Stroke::Inner, Stroke::Center, Stroke::Outer};
+        Stroke stroke("stroke", Color(0, 0, 0, 160), 1 + m_random.bounded(4), positions[m_random.bounded(3)]);
+        if(chance(0.25)) stroke.setStyle(Qt::DashLine);
+        item->addStroke(stroke);
+    }
+
+    if(chance(m_options.shadows)){
+        item->addShadow(Shadow("shadow", Color(0, 0, 0, 80), 4 + m_random.bounded(12), QPointF(0, 2 + m_random.bounded(6))));
+        if(chance(0.5)) item->addInnerShadow(Shadow("inner", Color(255, 255, 255, 120), 4, QPointF(0, 1)));
+    }
+
+    return item;
+}
+
+
+bool SceneGenerator::chance(qreal ratio)
+{
+    return m_random.generateDouble() < ratio;
+}
+
+
+/*!
+ * \brief Writes the image used by image fills into a temporary directory on first use.
+ */
+QString SceneGenerator::imagePath()
+{
+    if(m_imagePath.isEmpty() && m_tempDir.isValid()){
+
+        QImage image(256, 256, QImage::Format_ARGB32_Premultiplied);
+        QRadialGradient gradient(128, 128, 128);
+        gradient.setColorAt(0, QColor(255, 200, 0));
+        gradient.setColorAt(1, QColor(255, 80, 0));
+
+        QPainter painter(&image);
+        painter.fillRect(image.rect(), gradient);
+        painter.end();
+
+        m_imagePath = m_tempDir.filePath("fill.png");
+        image.save(m_imagePath);
+    }
+
+    return m_imagePath;
+}
@@ -0,0 +1,72 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef SCENEGENERATOR_H
+#define SCENEGENERATOR_H
+
+#include <QList>
+#include <QRandomGenerator>
+#include <QSizeF>
+#include <QTemporaryDir>
+
+class AbstractItemBase;
+class Artboard;
+class CanvasScene;
+
+/*!
+ * \brief Builds synthetic documents of N artboards with M items each.
+ * Styles are assigned by ratio with a fixed seed, so two runs with the same options produce the same document.
+ */
+class SceneGenerator
+{
+public:
+
+    struct Options {
+        int artboards = 10;
+        int items = 50;
+        qreal shadows = 0.3;
+        qreal strokes = 0.5;
+        qreal gradients = 0.2;
+        qreal images = 0.1;
+        qreal texts = 0.1;
+        quint32 seed = 42;
+    };
+
+    SceneGenerator(const Options &options = Options());
+
+    QList<Artboard*> populate(CanvasScene *scene);
+    Options options() const;
+
+private:
+
+    Options m_options;
+    QRandomGenerator m_random;
+    QTemporaryDir m_tempDir;
+    QString m_imagePath;
+
+    AbstractItemBase *createItem(int index, const QSizeF &bounds);
+    bool chance(qreal ratio);
+    QString imagePath();
+
+};
+
+#endif // SCENEGENERATOR_H
@@ -0,0 +1,108 @@
+#-------------------------------------------------
+#
+# Draftoola core: items, designer and render managers.
+# Shared by the application and the benchmark target.
+#
+#-------------------------------------------------
+
+QT += svg concurrent
+
+# frame timing HUD and trace export, see src/common/profiler.h
+profiling {
+    DEFINES += DRAFTOOLA_PROFILING
+}
+
+# row based PNG and JPG encoding of large exports, see src/manager/imagestreamwriter.h
+unix:packagesExist(libpng libjpeg) {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += libpng libjpeg
+    DEFINES += DRAFTOOLA_STREAM_ENCODER
+}
+
+SOURCES += \
+    $$PWD/src/common/profiler.cpp \
+    $$PWD/src/designer/canvasscene.cpp \
+    $$PWD/src/designer/canvasview.cpp \
+    $$PWD/src/designer/documentio.cpp \
+    $$PWD/src/designer/exportengine.cpp \
+    $$PWD/src/designer/handleframe.cpp \
+    $$PWD/src/designer/ruler.cpp \
+    $$PWD/src/designer/spatialindex.cpp \
+    $$PWD/src/designer/tilerenderer.cpp \
+    $$PWD/src/item/abstractitembase.cpp \
+    $$PWD/src/item/artboard.cpp \
+    $$PWD/src/item/itembase.cpp \
+    $$PWD/src/item/itemgroup.cpp \
+    $$PWD/src/item/itemoval.cpp \
+    $$PWD/src/item/itempolygon.cpp \
+    $$PWD/src/item/itemrect.cpp \
+    $$PWD/src/item/itemtext.cpp \
+    $$PWD/src/item/members/abstractitemproperty.cpp \
+    $$PWD/src/item/members/abstractproperty.cpp \
+    $$PWD/src/item/members/blurprocessor.cpp \
+    $$PWD/src/item/members/color.cpp \
+    $$PWD/src/item/members/exportlevel.cpp \
+    $$PWD/src/item/members/fills.cpp \
+    $$PWD/src/item/members/gradient.cpp \
+    $$PWD/src/item/members/offsetprocessor.cpp \
+    $$PWD/src/item/members/pathprocessor.cpp \
+    $$PWD/src/item/members/shadow.cpp \
+    $$PWD/src/item/members/shapetemplate.cpp \
+    $$PWD/src/item/members/stroke.cpp \
+    $$PWD/src/manager/displaylist.cpp \
+    $$PWD/src/manager/imagestreamwriter.cpp \
+    $$PWD/src/manager/lodpolicy.cpp \
+    $$PWD/src/manager/qt2skia.cpp \
+    $$PWD/src/manager/rectpacker.cpp \
+    $$PWD/src/manager/skia2qt.cpp \
+    $$PWD/src/manager/skiarenderer.cpp \
+    $$PWD/src/manager/stylefactory.cpp
+
+HEADERS += \
+    $$PWD/src/common/profiler.h \
+    $$PWD/src/common/skia_includes.h \
+    $$PWD/src/common/utilities.h \
+    $$PWD/src/designer/canvasscene.h \
+    $$PWD/src/designer/canvasview.h \
+    $$PWD/src/designer/documentio.h \
+    $$PWD/src/designer/exportengine.h \
+    $$PWD/src/designer/handleframe.h \
+    $$PWD/src/designer/ruler.h \
+    $$PWD/src/designer/spatialindex.h \
+    $$PWD/src/designer/tilerenderer.h \
+    $$PWD/src/item/abstractitembase.h \
+    $$PWD/src/item/artboard.h \
+    $$PWD/src/item/itembase.h \
+    $$PWD/src/item/itemgroup.h \
+    $$PWD/src/item/itemindex.h \
+    $$PWD/src/item/itemoval.h \
+    $$PWD/src/item/itempolygon.h \
+    $$PWD/src/item/itemrect.h \
+    $$PWD/src/item/itemtext.h \
+    $$PWD/src/item/members/abstractitemproperty.h \
+    $$PWD/src/item/members/abstractproperty.h \
+    $$PWD/src/item/members/blurprocessor.h \
+    $$PWD/src/item/members/color.h \
+    $$PWD/src/item/members/exportlevel.h \
+    $$PWD/src/item/members/fills.h \
+    $$PWD/src/item/members/gradient.h \
+    $$PWD/src/item/members/offsetprocessor.h \
+    $$PWD/src/item/members/pathprocessor.h \
+    $$PWD/src/item/members/shadow.h \
+    $$PWD/src/item/members/shapetemplate.h \
+    $$PWD/src/item/members/stroke.h \
+    $$PWD/src/manager/displaylist.h \
+    $$PWD/src/manager/imagestreamwriter.h \
+    $$PWD/src/manager/lodpolicy.h \
+    $$PWD/src/manager/qt2skia.h \
+    $$PWD/src/manager/rectpacker.h \
+    $$PWD/src/manager/skia2qt.h \
+    $$PWD/src/manager/skiarenderer.h \
+    $$PWD/src/manager/stylefactory.h
+
+INCLUDEPATH += \
+    $$PWD/src/common \
+    $$PWD/src/designer \
+    $$PWD/src/item \
+    $$PWD/src/item/members \
+    $$PWD/src/manager
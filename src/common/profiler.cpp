@@ -0,0 +1,343 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "profiler.h"
+
+#ifdef DRAFTOOLA_PROFILING
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+#include <algorithm>
+#include <atomic>
+
+// events are dropped once the trace is full
+static const int MaxEvents = 1000000;
+// number of frames used for the average frame time
+static const int FrameHistory = 60;
+
+namespace {
+
+struct Event {
+    const char *name;
+    const char *category;
+    QString item;
+    qint64 start;
+    qint64 duration;
+    quint64 thread;
+};
+
+struct CounterSample {
+    qint64 time;
+    QHash<QByteArray, qint64> values;
+};
+
+struct ProfilerData {
+    QMutex mutex;
+    QElapsedTimer clock;
+    std::atomic<bool> enabled;
+
+    QVector<Event> events;
+    QVector<CounterSample> counterSamples;
+    int droppedEvents = 0;
+
+    // current frame
+    qint64 frameStart = -1;
+    QHash<QByteArray, qint64> phases;
+    QHash<QByteArray, qint64> counters;
+
+    // last finished frame, shown in the HUD
+    QHash<QByteArray, qint64> lastPhases;
+    QHash<QByteArray, qint64> lastCounters;
+    QVector<qint64> frameTimes;
+
+    ProfilerData() : enabled(false) { clock.start(); }
+};
+
+ProfilerData &data()
+{
+    static ProfilerData instance;
+    return instance;
+}
+
+quint64 threadId()
+{
+    return reinterpret_cast<quint64>(QThread::currentThreadId());
+}
+
+}
+
+/***************************************************
+ *
+ * Scope
+ *
+ ***************************************************/
+
+Profiler::Scope::Scope(const char *name, const char *category, const QString &item) :
+    m_name(name),
+    m_category(category),
+    m_item(item),
+    m_start(0),
+    m_active(Profiler::isEnabled())
+{
+    if(m_active) m_start = Profiler::now();
+}
+
+Profiler::Scope::~Scope()
+{
+    if(m_active) Profiler::addEvent(m_name, m_category, m_item, m_start, Profiler::now() - m_start);
+}
+
+/***************************************************
+ *
+ * Public
+ *
+ ***************************************************/
+
+/*!
+ * \brief Starts or stops recording. Recorded events stay until clear() is called.
+ * \param enabled
+ */
+void Profiler::setEnabled(bool enabled)
+{
+    data().enabled = enabled;
+}
+
+bool Profiler::isEnabled()
+{
+    return data().enabled;
+}
+
+void Profiler::beginFrame()
+{
+    if(!isEnabled()) return;
+
+    ProfilerData &d = data();
+    QMutexLocker locker(&d.mutex);
+
+    d.frameStart = now();
+    d.phases.clear();
+    d.counters.clear();
+}
+
+
+/*!
+ * \brief Closes the current frame. Phase times and counters of the frame become the HUD values.
+ */
+void Profiler::endFrame()
+{
+    if(!isEnabled()) return;
+
+    ProfilerData &d = data();
+    const qint64 end = now();
+    qint64 start;
+
+    {
+        QMutexLocker locker(&d.mutex);
+        if(d.frameStart < 0) return;
+
+        start = d.frameStart;
+        d.frameStart = -1;
+
+        d.lastPhases = d.phases;
+        d.lastCounters = d.counters;
+
+        d.frameTimes.append(end - start);
+        if(d.frameTimes.size() > FrameHistory) d.frameTimes.removeFirst();
+
+        if(!d.counters.isEmpty() && d.counterSamples.size() < MaxEvents){
+            d.counterSamples.append({end, d.counters});
+        }
+    }
+
+    addEvent("Frame", "frame", QString(), start, end - start);
+}
+
+
+void Profiler::count(const char *name, qint64 amount)
+{
+    if(!isEnabled()) return;
+
+    ProfilerData &d = data();
+    QMutexLocker locker(&d.mutex);
+
+    d.counters[QByteArray::fromRawData(name, static_cast<int>(qstrlen(name)))] += amount;
+}
+
+
+/*!
+ * \brief Returns text lines for the HUD: frame time, time per phase and counters of the last frame.
+ * \return
+ */
+QStringList Profiler::summary()
+{
+    ProfilerData &d = data();
+    QMutexLocker locker(&d.mutex);
+
+    QStringList lines;
+
+    qint64 total = 0;
+    qint64 worst = 0;
+    foreach(qint64 time, d.frameTimes){
+        total += time;
+        worst = qMax(worst, time);
+    }
+
+    const double average = d.frameTimes.isEmpty() ? 0 : total / 1e6 / d.frameTimes.size();
+    const double last = d.frameTimes.isEmpty() ? 0 : d.frameTimes.last() / 1e6;
+
+    lines.append(QString("frame %1 ms (avg %2 ms, max %3 ms, %4 fps)")
+                 .arg(last, 0, 'f', 2)
+                 .arg(average, 0, 'f', 2)
+                 .arg(worst / 1e6, 0, 'f', 2)
+                 .arg(average > 0 ? 1000.0 / average : 0, 0, 'f', 1));
+
+    QList<QByteArray> phases = d.lastPhases.keys();
+    std::sort(phases.begin(), phases.end());
+    foreach(const QByteArray &phase, phases){
+        lines.append(QString("  %1: %2 ms").arg(QString::fromLatin1(phase)).arg(d.lastPhases.value(phase) / 1e6, 0, 'f', 3));
+    }
+
+    QList<QByteArray> counters = d.lastCounters.keys();
+    std::sort(counters.begin(), counters.end());
+    foreach(const QByteArray &counter, counters){
+        lines.append(QString("  # %1: %2").arg(QString::fromLatin1(counter)).arg(d.lastCounters.value(counter)));
+    }
+
+    if(d.droppedEvents > 0) lines.append(QString("  %1 events dropped").arg(d.droppedEvents));
+
+    return lines;
+}
+
+
+/*!
+ * \brief Writes all recorded events as Chrome trace event JSON (chrome://tracing, Perfetto).
+ * \param fileName
+ * \return false if the file can't be written
+ */
+bool Profiler::writeTrace(const QString &fileName)
+{
+    ProfilerData &d = data();
+    QMutexLocker locker(&d.mutex);
+
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray traceEvents;
+
+    foreach(const Event &event, d.events){
+        QJsonObject object;
+        object.insert("name", QString::fromLatin1(event.name));
+        object.insert("cat", QString::fromLatin1(event.category));
+        object.insert("ph", "X");
+        object.insert("ts", event.start / 1000.0);
+        object.insert("dur", event.duration / 1000.0);
+        object.insert("pid", pid);
+        object.insert("tid", QString::number(event.thread));
+
+        if(!event.item.isEmpty()){
+            QJsonObject args;
+            args.insert("item", event.item);
+            object.insert("args", args);
+        }
+
+        traceEvents.append(object);
+    }
+
+    foreach(const CounterSample &sample, d.counterSamples){
+        QJsonObject args;
+        QHash<QByteArray, qint64>::const_iterator it;
+        for(it = sample.values.constBegin(); it != sample.values.constEnd(); ++it){
+            args.insert(QString::fromLatin1(it.key()), it.value());
+        }
+
+        QJsonObject object;
+        object.insert("name", "counters");
+        object.insert("ph", "C");
+        object.insert("ts", sample.time / 1000.0);
+        object.insert("pid", pid);
+        object.insert("args", args);
+
+        traceEvents.append(object);
+    }
+
+    QJsonObject root;
+    root.insert("traceEvents", traceEvents);
+    root.insert("displayTimeUnit", "ms");
+
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    return file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) >= 0;
+}
+
+
+void Profiler::clear()
+{
+    ProfilerData &d = data();
+    QMutexLocker locker(&d.mutex);
+
+    d.events.clear();
+    d.counterSamples.clear();
+    d.droppedEvents = 0;
+    d.phases.clear();
+    d.counters.clear();
+    d.lastPhases.clear();
+    d.lastCounters.clear();
+    d.frameTimes.clear();
+}
+
+/***************************************************
+ *
+ * Private
+ *
+ ***************************************************/
+
+qint64 Profiler::now()
+{
+    return data().clock.nsecsElapsed();
+}
+
+
+void Profiler::addEvent(const char *name, const char *category, const QString &item, qint64 start, qint64 duration)
+{
+    ProfilerData &d = data();
+    QMutexLocker locker(&d.mutex);
+
+    if(d.frameStart >= 0) d.phases[QByteArray::fromRawData(name, static_cast<int>(qstrlen(name)))] += duration;
+
+    if(d.events.size() >= MaxEvents){
+        d.droppedEvents++;
+        return;
+    }
+
+    d.events.append({name, category, item, start, duration, threadId()});
+}
+
+#endif // DRAFTOOLA_PROFILING
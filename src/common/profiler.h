@@ -0,0 +1,98 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+/*!
+ * Frame and render phase instrumentation. Build with CONFIG+=profiling to define DRAFTOOLA_PROFILING,
+ * otherwise all PROFILE_* macros expand to nothing and no profiler code is compiled.
+ *
+ * PROFILE_SCOPE(name, category)             times the enclosing scope
+ * PROFILE_ITEM_SCOPE(name, category, item)  times the enclosing scope, item is stored as event argument
+ * PROFILE_COUNT(name)                       increases a counter of the current frame
+ * PROFILE_FRAME_BEGIN() / PROFILE_FRAME_END()
+ *
+ * Names and categories have to be string literals.
+ */
+
+#ifdef DRAFTOOLA_PROFILING
+
+#include <QString>
+#include <QStringList>
+
+class Profiler
+{
+public:
+
+    class Scope
+    {
+    public:
+        Scope(const char *name, const char *category, const QString &item = QString());
+        ~Scope();
+
+    private:
+        const char *m_name;
+        const char *m_category;
+        QString m_item;
+        qint64 m_start;
+        bool m_active;
+    };
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    static void beginFrame();
+    static void endFrame();
+    static void count(const char *name, qint64 amount = 1);
+
+    static QStringList summary();
+    static bool writeTrace(const QString &fileName);
+    static void clear();
+
+private:
+
+    static qint64 now();
+    static void addEvent(const char *name, const char *category, const QString &item, qint64 start, qint64 duration);
+
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#define PROFILE_SCOPE(name, category) Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name, category)
+#define PROFILE_ITEM_SCOPE(name, category, item) Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name, category, item)
+#define PROFILE_COUNT(name) Profiler::count(name)
+#define PROFILE_FRAME_BEGIN() Profiler::beginFrame()
+#define PROFILE_FRAME_END() Profiler::endFrame()
+
+#else
+
+#define PROFILE_SCOPE(name, category)
+#define PROFILE_ITEM_SCOPE(name, category, item)
+#define PROFILE_COUNT(name)
+#define PROFILE_FRAME_BEGIN()
+#define PROFILE_FRAME_END()
+
+#endif // DRAFTOOLA_PROFILING
+
+#endif // PROFILER_H
@@ -26,7 +26,17 @@
 #include <SkMatrix.h>
 #include <SkPoint.h>
 #include <SkPath.h>
+#include <SkRRect.h>
 #include <SkPathTypes.h>
 #include <SkPathOps.h>
 
+// raster backend
+#include <SkCanvas.h>
+#include <SkPaint.h>
+#include <SkImage.h>
+#include <SkShader.h>
+#include <SkMaskFilter.h>
+#include <SkBlurTypes.h>
+#include <SkDashPathEffect.h>
+
 #endif // SKIAINCLUDES_H
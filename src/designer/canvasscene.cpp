@@ -24,11 +24,9 @@
 #include <QDebug>
 #include <QtGlobal>
 #include <QGraphicsSceneMouseEvent>
-#include <QSvgGenerator>
-#include <QPdfWriter>
 
-#include <QCoreApplication>
 #include <handleframe.h>
+#include <profiler.h>
 
 //#include <QGraphicsItemGroup>
 //#include <QGraphicsDropShadowEffect>
@@ -48,6 +46,8 @@ CanvasScene::CanvasScene(QObject *parent) : QGraphicsScene(parent)
 
     m_color = QColor(0, 128, 255);
 
+    m_exportEngine = new ExportEngine(this);
+
     m_handleFrame = new HandleFrame(this, m_grid);
     m_handleFrame->setColor(m_color);
     addItem(m_handleFrame);
@@ -62,6 +62,11 @@ HandleFrame *CanvasScene::handleFrame()
     return m_handleFrame;
 }
 
+ExportEngine *CanvasScene::exportEngine()
+{
+    return m_exportEngine;
+}
+
 /***************************************************
  *
  * Properties
@@ -78,154 +83,153 @@ void CanvasScene::setScaleFactor(qreal factor)
     m_scaleFactor = factor;
 }
 
-
 /***************************************************
  *
- * Slots
+ * Spatial Index
  *
  ***************************************************/
 
 /*!
- * \brief [SLOT] Export all items on canvas into all provided output formats.
+ * \brief Marks item bounds as outdated. The index gets updated with the next query.
+ * \param item
  */
-void CanvasScene::exportItems()
+void CanvasScene::indexItem(AbstractItemBase *item)
 {
-    this->clearSelection();
-
-    foreach(QGraphicsItem *item, this->items()){
-
-        AbstractItemBase * aItem = dynamic_cast<AbstractItemBase*>(item);
-        if(aItem){
-            exportItem(aItem);
-        }
-
-    }
+    m_dirtyItems.insert(item);
+}
 
+void CanvasScene::unindexItem(AbstractItemBase *item)
+{
+    m_dirtyItems.remove(item);
+    m_index.remove(item);
 }
 
 /*!
- * \brief [SLOT] Export single item into all provided output formats.
- * \param item
+ * \brief Returns all document items at the position. Replacement of QGraphicsScene::items() which doesn't scan all items.
+ * Only AbstractItemBase items are indexed, helper items like the HandleFrame are not part of the result.
+ * \param pos
+ * \param mode
+ * \param order
+ * \return
  */
-void CanvasScene::exportItem(AbstractItemBase *item)
+QList<QGraphicsItem *> CanvasScene::indexedItems(const QPointF &pos, Qt::ItemSelectionMode mode, Qt::SortOrder order) const
 {
-    if(item){
-
-        foreach(ExportLevel expLevel, item->exportLevels()){
-
-            double multiplier = expLevel.renderLevel();
-
-            QString output = (expLevel.pathType() == ExportLevel::PathType::prefix)
-                    ? expLevel.path() + item->name()
-                    : item->name() + expLevel.path();
-
-            switch(expLevel.fileFormat()){
-            case ExportLevel::FileFormat::JPG:
-                saveImage(item, multiplier, output + ".jpg", Qt::white);
-                break;
-            case ExportLevel::FileFormat::SVG:
-                saveSVG(item, output + ".svg");
-                break;
-            case ExportLevel::FileFormat::PDF:
-                savePDF(item, output + ".pdf");
-                break;
-            default:
-            case ExportLevel::FileFormat::PNG:
-                saveImage(item, multiplier, output + ".png");
-                break;
-            }
+    flushIndex();
+
+    QList<QGraphicsItem*> list;
+
+    foreach(QGraphicsItem *item, m_index.items(pos)){
+        switch(mode){
+        case Qt::IntersectsItemBoundingRect:
+        case Qt::ContainsItemBoundingRect:
+            list.append(item); // index rect is the scene bounding rect
+            break;
+        case Qt::IntersectsItemShape:
+        case Qt::ContainsItemShape:
+            if(item->contains(item->mapFromScene(pos))) list.append(item);
+            break;
         }
-
     }
-}
 
-void CanvasScene::updateLabels()
-{
+    m_index.sortByStackingOrder(list, order);
 
+    return list;
 }
 
-
 /*!
- * \brief Render object as Image and save it under given output path.
- * \param bi
- * \param multiplier
- * \param outputPath
+ * \brief Returns all document items in the rect. Replacement of QGraphicsScene::items() which doesn't scan all items.
+ * \param rect
+ * \param mode
+ * \param order
+ * \return
  */
-void CanvasScene::saveImage(AbstractItemBase *bi, qreal multiplier, const QString outputPath, QColor bgColor)
+QList<QGraphicsItem *> CanvasScene::indexedItems(const QRectF &rect, Qt::ItemSelectionMode mode, Qt::SortOrder order) const
 {
+    flushIndex();
+
+    QList<QGraphicsItem*> list;
+    QPainterPath area;
+    area.addRect(rect);
+
+    foreach(QGraphicsItem *item, m_index.items(rect)){
+        switch(mode){
+        case Qt::IntersectsItemBoundingRect:
+            list.append(item);
+            break;
+        case Qt::ContainsItemBoundingRect:
+            if(rect.contains(item->sceneBoundingRect())) list.append(item);
+            break;
+        case Qt::IntersectsItemShape:
+        case Qt::ContainsItemShape:
+            if(item->collidesWithPath(item->mapFromScene(area), mode)) list.append(item);
+            break;
+        }
+    }
 
-    QImage image(QSizeF(bi->renderRect().width()*multiplier,bi->renderRect().height()*multiplier ).toSize(), QImage::Format_ARGB32_Premultiplied);
-    image.fill(bgColor);
+    m_index.sortByStackingOrder(list, order);
 
-    QPainter painter(&image);
-    painter.scale(multiplier,multiplier);
-    painter.translate(bi->renderRect().topLeft().x() * -1, bi->renderRect().topLeft().y() * -1);
-    bi->render(&painter);
-    painter.end();
+    return list;
+}
 
-    image.save(outputPath, nullptr, 100);
+void CanvasScene::flushIndex() const
+{
+    foreach(AbstractItemBase *item, m_dirtyItems){
+        if(item->scene() == this && item->isVisible()){
+            m_index.update(item, item->sceneBoundingRect());
+        }else{
+            m_index.remove(item);
+        }
+    }
 
+    m_dirtyItems.clear();
 }
 
+
+/***************************************************
+ *
+ * Slots
+ *
+ ***************************************************/
+
 /*!
- * \brief Convert object as SVG and save it under given output path.
- * \param bi
- * \param outputPath
+ * \brief [SLOT] Export all items on canvas into all provided output formats.
+ * The export runs in the background, see exportEngine() for progress.
  */
-void CanvasScene::saveSVG(AbstractItemBase *bi, const QString outputPath)
+void CanvasScene::exportItems()
 {
-    QRectF targetRect = bi->renderRect();
-
-    QSvgGenerator generator;
-    generator.setFileName(outputPath);
-    generator.setSize(targetRect.size().toSize());  // Set the dimensions of the working area of the document in millimeters
-    generator.setViewBox(targetRect);
-    generator.setTitle(bi->name());
-    generator.setDescription(tr("File created by ") + QCoreApplication::applicationName() );
-    generator.setResolution(72);
-
-    QPainter painter(&generator);
+    this->clearSelection();
 
-    AbstractItemBase::RenderQuality renderQuality = bi->renderQuality();
+    QList<AbstractItemBase*> exportList;
 
-    bi->setRenderQuality(AbstractItemBase::Quality);
-    bi->render(&painter);
-    bi->setRenderQuality(renderQuality);
+    foreach(QGraphicsItem *item, this->items()){
 
-    painter.end();
+        AbstractItemBase * aItem = dynamic_cast<AbstractItemBase*>(item);
+        if(aItem){
+            exportList.append(aItem);
+        }
 
+    }
 
+    m_exportEngine->exportItems(exportList);
 }
 
 /*!
- * \brief Render object as PDF and save it under given output path.
- * \param bi
- * \param outputPath
+ * \brief [SLOT] Export single item into all provided output formats.
+ * \param item
  */
-void CanvasScene::savePDF(AbstractItemBase *bi, const QString outputPath)
+void CanvasScene::exportItem(AbstractItemBase *item)
 {
-    QPageSize pSize(QSizeF(bi->renderRect().size()).toSize());
-
-    QPdfWriter pdfWriter(outputPath);
-    pdfWriter.setPageSize(pSize);
-    pdfWriter.setTitle(bi->name());
-    pdfWriter.setPageMargins(QMargins(0, 0, 0, 0));
-    pdfWriter.setResolution(72);
-    pdfWriter.setCreator(tr("File created by ") + QCoreApplication::applicationName() );
-
-    QPainter painter(&pdfWriter);
-    painter.translate(bi->renderRect().topLeft().x() * -1, bi->renderRect().topLeft().y() * -1);
-
-    AbstractItemBase::RenderQuality renderQuality = bi->renderQuality();
-
-    bi->setRenderQuality(AbstractItemBase::Quality);
-    bi->render(&painter);
-    bi->setRenderQuality(renderQuality);
+    if(item){
+        m_exportEngine->exportItems({item});
+    }
+}
 
-    painter.end();
+void CanvasScene::updateLabels()
+{
 
 }
 
+
 /***************************************************
  *
  * Events
@@ -256,6 +260,8 @@ void CanvasScene::drawForeground(QPainter *painter, const QRectF &rect)
 
     // draw grid
     if (scaleFactor() > 10 ) {
+        PROFILE_SCOPE("grid", "gui");
+
         // painter->setClipRect( rect);
 
         qreal left = int(rect.left()) - (int(rect.left()) % m_grid);
@@ -298,7 +304,7 @@ void CanvasScene::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 
     QPoint mousePos = event->scenePos().toPoint();
 
-    QList<QGraphicsItem*> list = this->items(mousePos,Qt::IntersectsItemShape, Qt::DescendingOrder, QTransform() );
+    QList<QGraphicsItem*> list = indexedItems(QPointF(mousePos), Qt::IntersectsItemShape, Qt::DescendingOrder);
 
     if(m_hoverPath != QPainterPath()){
         m_hoverPath = QPainterPath();
@@ -307,21 +313,11 @@ void CanvasScene::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 
     if(list.isEmpty()) return;
 
-    QGraphicsItem * cgItem = list.first();
-
-    if(cgItem->type() == HandleFrame::Type::Handle && list.count() >1){
-        cgItem = list[1]; // skip handleFrame
-    }
-
-    if(cgItem->type() == ArtboardCanvas::Type::Canvas){
-        Artboard * artboard = dynamic_cast<Artboard*>(cgItem->parentItem());
-        if(artboard && cgItem->childItems().isEmpty()){
-            cgItem = cgItem->parentItem(); // get Artboard instead of canvas
-        }
-
-    }
+    AbstractItemBase * item = dynamic_cast<AbstractItemBase*>(list.first());
 
-    AbstractItemBase * item = dynamic_cast<AbstractItemBase*>(cgItem);
+    // artboards are only highlighted if their canvas is empty
+    Artboard * artboard = dynamic_cast<Artboard*>(item);
+    if(artboard && !artboard->canvas()->childItems().isEmpty()) return;
 
     if(item){
 
@@ -25,22 +25,32 @@
 
 #include <QGraphicsScene>
 #include <QKeyEvent>
+#include <QSet>
 
 #include <itembase.h>
 #include <artboard.h>
+#include <itemindex.h>
 #include <handleframe.h>
+#include <spatialindex.h>
+#include <exportengine.h>
 
-class CanvasScene : public QGraphicsScene
+class CanvasScene : public QGraphicsScene, public ItemIndex
 {
     Q_OBJECT
 public:
     CanvasScene(QObject *parent = nullptr);
 
     HandleFrame *handleFrame();
+    ExportEngine *exportEngine();
 
     qreal scaleFactor() const;
     void setScaleFactor(qreal factor);
 
+    void indexItem(AbstractItemBase *item) override;
+    void unindexItem(AbstractItemBase *item) override;
+    QList<QGraphicsItem*> indexedItems(const QPointF &pos, Qt::ItemSelectionMode mode = Qt::IntersectsItemShape, Qt::SortOrder order = Qt::DescendingOrder) const;
+    QList<QGraphicsItem*> indexedItems(const QRectF &rect, Qt::ItemSelectionMode mode = Qt::IntersectsItemShape, Qt::SortOrder order = Qt::DescendingOrder) const;
+
 public slots:
     void exportItems();
     void exportItem(AbstractItemBase *item);
@@ -50,6 +60,7 @@ private slots:
 
 private:
     HandleFrame *m_handleFrame;
+    ExportEngine *m_exportEngine;
     qreal m_scaleFactor;
     int m_grid;
     QPainterPath m_hoverPath;
@@ -57,10 +68,11 @@ private:
     QTransform m_hoverTransform;
     qreal m_hoverRotation;
     QColor m_color;
+    mutable SpatialIndex m_index;
+    mutable QSet<AbstractItemBase*> m_dirtyItems;
+
+    void flushIndex() const;
 
-    void saveImage(AbstractItemBase *bi, qreal multiplier, const QString outputPath, QColor bgColor = Qt::transparent);
-    void saveSVG(AbstractItemBase *bi, const QString outputPath);
-    void savePDF(AbstractItemBase *bi, const QString outputPath);
 
 protected:
     void keyPressEvent(QKeyEvent *event);
@@ -34,7 +34,9 @@
 #include <QMimeData>
 #include <QApplication>
 #include <QClipboard>
+#include <QDir>
 #include <QtMath>
+#include <QStyleOptionGraphicsItem>
 
 #include <utilities.h>
 #include <artboard.h>
@@ -46,6 +48,7 @@
 #include <itemtext.h>
 #include <canvasscene.h>
 #include <handleframe.h>
+#include <profiler.h>
 
 static const QString mimeType("application/canvasItem");
 
@@ -66,6 +69,8 @@ CanvasView::CanvasView(QWidget * parent) : QGraphicsView(parent)
     //    this->setMouseTracking(true);
 
     m_renderQuality = AbstractItemBase::Balanced;
+    m_renderMode = RenderMode::DirectPaint;
+    m_tileRenderer = nullptr;
     m_activeArtboard = nullptr;
 
     setViewportMargins(RULER_SIZE,RULER_SIZE,0,0);
@@ -124,7 +129,7 @@ void CanvasView::resetItemCache()
 {
     QRectF _viewFrame = mapToScene( viewport()->geometry() ).boundingRect();
 
-    foreach(QGraphicsItem *item, m_scene->items(_viewFrame)){
+    foreach(QGraphicsItem *item, m_scene->indexedItems(_viewFrame, Qt::IntersectsItemBoundingRect)){
 
         ItemBase * b_item = dynamic_cast<ItemBase*>(item);
         if(b_item){
@@ -132,6 +137,10 @@ void CanvasView::resetItemCache()
             b_item->setCacheMode(QGraphicsItem::NoCache); // https://doc.qt.io/qt-5/qgraphicsitem.html#CacheMode-enum
             //b_item->setInvalidateCache(true); // needed for shadow map refresh
         }
+
+        // artboards pick their level of detail tiers by the same quality as the items
+        Artboard * a_item = dynamic_cast<Artboard*>(item);
+        if(a_item) a_item->setRenderQuality(m_renderQuality);
     }
 
 }
@@ -217,7 +226,7 @@ void CanvasView::filterSelection(QRect viewportRect, QPointF fromScenePoint, QPo
 
     QRectF rubberBand(posRubberbandTL, posRubberbandBR);
 
-    QList<QGraphicsItem *> selectedItems = m_scene->items(rubberBand, Qt::IntersectsItemShape, Qt::AscendingOrder, transform());
+    QList<QGraphicsItem *> selectedItems = m_scene->indexedItems(rubberBand, Qt::IntersectsItemShape, Qt::AscendingOrder);
 
     foreach(QGraphicsItem *selectedItem, selectedItems) {
 
@@ -303,6 +312,58 @@ void CanvasView::setRenderQuality(AbstractItemBase::RenderQuality renderQuality)
 }
 
 
+CanvasView::RenderMode CanvasView::renderMode() const
+{
+    return m_renderMode;
+}
+
+
+/*!
+ * \brief Switch between painting items directly on the gui thread and compositing tiles which are
+ * rasterized by worker threads from a recorded snapshot of the items.
+ * \param renderMode
+ */
+void CanvasView::setRenderMode(CanvasView::RenderMode renderMode)
+{
+    if(m_renderMode == renderMode) return;
+
+    m_renderMode = renderMode;
+
+    switch(m_renderMode){
+    case RenderMode::TiledPaint:
+        m_tileRenderer = new TileRenderer(m_scene, this);
+        connect(m_tileRenderer, &TileRenderer::tileReady, viewport(), QOverload<>::of(&QWidget::update));
+        break;
+    case RenderMode::DirectPaint:
+        delete m_tileRenderer;
+        m_tileRenderer = nullptr;
+        break;
+    }
+
+    viewport()->update();
+}
+
+SkiaRenderer::Backend CanvasView::renderBackend() const
+{
+    return SkiaRenderer::backend();
+}
+
+/*!
+ * \brief Switches between QPainter and Skia rasterization of items. The backend is shared by all views.
+ * \param backend
+ */
+void CanvasView::setRenderBackend(SkiaRenderer::Backend backend)
+{
+    if(SkiaRenderer::backend() == backend) return;
+
+    SkiaRenderer::setBackend(backend);
+
+    if(m_tileRenderer) m_tileRenderer->clear();
+    resetItemCache();
+    viewport()->update();
+}
+
+
 AbstractItemBase *CanvasView::itemByName(const QString name)
 {
     foreach(QGraphicsItem *item, m_scene->items()) {
@@ -598,7 +659,7 @@ void CanvasView::wheelEvent(QWheelEvent *event)
         // Performance optimization by zooming
         if(isZoomed) {
             QRectF _viewFrame = this->mapToScene( this->viewport()->geometry() ).boundingRect();
-            foreach(QGraphicsItem *item, m_scene->items(_viewFrame)){
+            foreach(QGraphicsItem *item, m_scene->indexedItems(_viewFrame, Qt::IntersectsItemBoundingRect)){
                 ItemBase * b_item = dynamic_cast<ItemBase*>(item);
                 if(b_item){
                     // keep the rendered item in cache while zooming. No redraw = better performance.
@@ -764,6 +825,26 @@ void CanvasView::keyReleaseEvent(QKeyEvent *event)
         m_scene->exportItems();
         break;
     }
+    case Qt::Key_T:{
+        setRenderMode((m_renderMode == RenderMode::DirectPaint) ? RenderMode::TiledPaint : RenderMode::DirectPaint);
+        break;
+    }
+    case Qt::Key_B:{
+        setRenderBackend((renderBackend() == SkiaRenderer::QPainterBackend) ? SkiaRenderer::SkiaBackend : SkiaRenderer::QPainterBackend);
+        break;
+    }
+#ifdef DRAFTOOLA_PROFILING
+    case Qt::Key_F11:{
+        QString fileName = QDir::temp().filePath("draftoola-trace.json");
+        if(Profiler::writeTrace(fileName)) qDebug() << "Trace written to" << fileName;
+        break;
+    }
+    case Qt::Key_F12:{
+        Profiler::setEnabled(!Profiler::isEnabled());
+        viewport()->update();
+        break;
+    }
+#endif
 
     }
 
@@ -788,6 +869,64 @@ void CanvasView::mousePressEvent(QMouseEvent *event)
 
 }
 
+void CanvasView::drawBackground(QPainter *painter, const QRectF &rect)
+{
+    QGraphicsView::drawBackground(painter, rect);
+
+    if(m_renderMode == RenderMode::TiledPaint && m_tileRenderer){
+        // tiles are rendered in device pixels
+        m_tileRenderer->paint(painter, rect, scaleFactor() * devicePixelRatioF());
+    }
+}
+
+#ifdef DRAFTOOLA_PROFILING
+void CanvasView::paintEvent(QPaintEvent *event)
+{
+    PROFILE_FRAME_BEGIN();
+    QGraphicsView::paintEvent(event);
+    PROFILE_FRAME_END();
+}
+
+/*!
+ * \brief Draws the timing HUD of the last frame on top of the scene. Toggled by F12, F11 writes a trace file.
+ */
+void CanvasView::drawForeground(QPainter *painter, const QRectF &rect)
+{
+    QGraphicsView::drawForeground(painter, rect);
+
+    if(!Profiler::isEnabled()) return;
+
+    const QStringList lines = Profiler::summary();
+
+    painter->save();
+    painter->resetTransform();
+    painter->setRenderHint(QPainter::Antialiasing, false);
+
+    QFont font("Monospace");
+    font.setStyleHint(QFont::TypeWriter);
+    font.setPixelSize(11);
+    painter->setFont(font);
+
+    const int lineHeight = painter->fontMetrics().height();
+    int width = 0;
+    foreach(const QString &line, lines){
+        width = qMax(width, painter->fontMetrics().boundingRect(line).width());
+    }
+
+    QRect box(8, 8, width + 16, lines.size() * lineHeight + 12);
+    painter->fillRect(box, QColor(0, 0, 0, 180));
+    painter->setPen(Qt::white);
+
+    int y = box.top() + 6 + painter->fontMetrics().ascent();
+    foreach(const QString &line, lines){
+        painter->drawText(box.left() + 8, y, line);
+        y += lineHeight;
+    }
+
+    painter->restore();
+}
+#endif
+
 void CanvasView::mouseReleaseEvent(QMouseEvent *event)
 {
     QGraphicsView::mouseReleaseEvent(event);
@@ -32,11 +32,19 @@
 #include <handleframe.h>
 #include <ruler.h>
 #include <itemgroup.h>
+#include <tilerenderer.h>
+#include <skiarenderer.h>
 
 class CanvasView : public QGraphicsView
 {
     Q_OBJECT
 public:
+
+    enum RenderMode {
+        DirectPaint = 0,
+        TiledPaint = 1
+    };
+
     CanvasView(QWidget * parent = nullptr);
     HandleFrame *handleFrame();
 
@@ -45,6 +53,12 @@ public:
     AbstractItemBase::RenderQuality renderQuality() const;
     void setRenderQuality(AbstractItemBase::RenderQuality renderQuality);
 
+    RenderMode renderMode() const;
+    void setRenderMode(RenderMode renderMode);
+
+    SkiaRenderer::Backend renderBackend() const;
+    void setRenderBackend(SkiaRenderer::Backend backend);
+
     AbstractItemBase *itemByName(const QString name);
     QList<Artboard *> artboardList();
 
@@ -57,6 +71,11 @@ protected:
     void mouseMoveEvent(QMouseEvent *event);
     void mousePressEvent(QMouseEvent *event);
     void mouseReleaseEvent(QMouseEvent *event);
+    void drawBackground(QPainter *painter, const QRectF &rect);
+#ifdef DRAFTOOLA_PROFILING
+    void paintEvent(QPaintEvent *event);
+    void drawForeground(QPainter *painter, const QRectF &rect);
+#endif
 
 private:
     CanvasScene	*m_scene;
@@ -66,6 +85,8 @@ private:
     QDRuler     *m_VRuler;
 
     AbstractItemBase::RenderQuality m_renderQuality;
+    RenderMode   m_renderMode;
+    TileRenderer *m_tileRenderer;
 
     void applyScaleFactor();
     qreal scaleFactor() const;
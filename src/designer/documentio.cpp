@@ -0,0 +1,356 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "documentio.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <artboard.h>
+#include <canvasscene.h>
+#include <itemgroup.h>
+#include <itemoval.h>
+#include <itempolygon.h>
+#include <itemrect.h>
+#include <itemtext.h>
+
+/***************************************************
+ *
+ * Public
+ *
+ ***************************************************/
+
+/*!
+ * \brief Adds all artboards of a document to the scene. Relative image paths are resolved against the document location.
+ * \param fileName
+ * \param scene
+ * \param errorMessage set if the document can't be read
+ * \return false if the file can't be opened or is no valid document
+ */
+bool DocumentIO::load(const QString &fileName, CanvasScene *scene, QString *errorMessage)
+{
+    QFile file(fileName);
+
+    if(!file.open(QIODevice::ReadOnly)){
+        if(errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+
+    if(parseError.error != QJsonParseError::NoError){
+        if(errorMessage) *errorMessage = parseError.errorString() + " at offset " + QString::number(parseError.offset);
+        return false;
+    }
+
+    const QJsonValue artboards = document.object().value("artboards");
+
+    if(!artboards.isArray()){
+        if(errorMessage) *errorMessage = "document has no artboards";
+        return false;
+    }
+
+    // image fills reference files relative to the document
+    const QDir directory = QFileInfo(fileName).absoluteDir();
+
+    foreach(QJsonValue value, artboards.toArray()){
+        Artboard *artboard = readArtboard(value.toObject(), directory);
+        scene->addItem(artboard);
+        artboard->setPos(readPoint(value.toObject().value("pos")));
+    }
+
+    return true;
+}
+
+/***************************************************
+ *
+ * Private
+ *
+ ***************************************************/
+
+Artboard *DocumentIO::readArtboard(const QJsonObject &object, const QDir &directory)
+{
+    Artboard *artboard = new Artboard(object.value("name").toString("Artboard"));
+
+    if(object.contains("rect")) artboard->setRect(readRect(object.value("rect")));
+
+    if(object.contains("backgroundColor")){
+        artboard->setBackgroundColor(readColor(object.value("backgroundColor"), Qt::white));
+    }
+    artboard->setUseBackgroundColor(object.value("useBackgroundColor").toBool(true));
+
+    readCommon(object, artboard);
+    readChildren(object, artboard, directory);
+
+    return artboard;
+}
+
+/*!
+ * \brief Creates an item of the given type, returns nullptr for unknown types.
+ */
+AbstractItemBase *DocumentIO::readItem(const QJsonObject &object, const QDir &directory)
+{
+    const QString type = object.value("type").toString();
+    const QRectF rect = readRect(object.value("rect"));
+
+    AbstractItemBase *item = nullptr;
+
+    if(type == "rect"){
+        ItemRect *itemRect = new ItemRect(rect);
+
+        const QJsonValue radius = object.value("radius");
+        if(radius.isArray()){
+            const QJsonArray corners = radius.toArray();
+            itemRect->setRadius(corners.at(0).toDouble(), corners.at(1).toDouble(),
+                                corners.at(2).toDouble(), corners.at(3).toDouble());
+        }else{
+            itemRect->setRadius(radius.toDouble());
+        }
+
+        item = itemRect;
+
+    }else if(type == "oval"){
+        item = new ItemOval(rect);
+
+    }else if(type == "polygon" || type == "star"){
+        const bool isStar = (type == "star");
+        ItemPolygon *polygon = new ItemPolygon(rect, object.value("sides").toInt(isStar ? 5 : 6), isStar);
+        if(object.contains("innerRadius")) polygon->setInnerRadius(object.value("innerRadius").toDouble());
+        item = polygon;
+
+    }else if(type == "text"){
+        ItemText *text = new ItemText(object.value("text").toString());
+        if(object.contains("fontSize")) text->setFontSize(object.value("fontSize").toInt());
+        if(object.contains("textColor")) text->setTextColor(readColor(object.value("textColor")));
+        item = text;
+
+    }else if(type == "group"){
+        item = new ItemGroup();
+
+    }else{
+        qWarning("DocumentIO: skipped item of unknown type \"%s\"", qPrintable(type));
+        return nullptr;
+    }
+
+    if(object.contains("name")) item->setName(object.value("name").toString());
+
+    ItemBase *itemBase = dynamic_cast<ItemBase*>(item);
+    if(itemBase) readItemBase(object, itemBase, directory);
+
+    readCommon(object, item);
+    readChildren(object, item, directory);
+
+    return item;
+}
+
+
+void DocumentIO::readItemBase(const QJsonObject &object, ItemBase *item, const QDir &directory)
+{
+    foreach(QJsonValue value, object.value("fills").toArray()){
+        item->addFills(readFills(value.toObject(), directory));
+    }
+
+    foreach(QJsonValue value, object.value("strokes").toArray()){
+        item->addStroke(readStroke(value.toObject()));
+    }
+
+    foreach(QJsonValue value, object.value("shadows").toArray()){
+        item->addShadow(readShadow(value.toObject()));
+    }
+
+    foreach(QJsonValue value, object.value("innerShadows").toArray()){
+        item->addInnerShadow(readShadow(value.toObject()));
+    }
+}
+
+/*!
+ * \brief Reads the properties shared by artboards and items: export levels and rotation.
+ */
+void DocumentIO::readCommon(const QJsonObject &object, AbstractItemBase *item)
+{
+    const QJsonArray levels = object.value("exportLevels").toArray();
+
+    for(int i = 0; i < levels.count(); ++i){
+        item->addExportLevel(readExportLevel(levels.at(i).toObject(), i));
+    }
+
+    if(object.contains("rotation")) item->setRotation(object.value("rotation").toDouble());
+}
+
+
+void DocumentIO::readChildren(const QJsonObject &object, AbstractItemBase *parent, const QDir &directory)
+{
+    foreach(QJsonValue value, object.value("items").toArray()){
+
+        AbstractItemBase *item = readItem(value.toObject(), directory);
+        if(!item) continue;
+
+        // groups derive their frame from the child positions
+        item->setPos(readPoint(value.toObject().value("pos")));
+        parent->addItem(item);
+    }
+}
+
+
+Fills DocumentIO::readFills(const QJsonObject &object, const QDir &directory)
+{
+    const QString name = object.value("name").toString("fill");
+
+    Fills fills;
+
+    if(object.contains("gradient")){
+        fills = Fills(name, readGradient(object.value("gradient").toObject()));
+    }else if(object.contains("image")){
+        const QString mode = object.value("mode").toString();
+        Fills::FillMode fillMode = Fills::Fill;
+        if(mode == "fit") fillMode = Fills::Fit;
+        else if(mode == "stretch") fillMode = Fills::Stretch;
+        else if(mode == "tile") fillMode = Fills::Tile;
+
+        fills = Fills(name, directory.absoluteFilePath(object.value("image").toString()), fillMode);
+    }else{
+        fills = Fills(name, readColor(object.value("color")));
+    }
+
+    if(object.contains("opacity")) fills.setOpacity(object.value("opacity").toDouble());
+
+    return fills;
+}
+
+
+Stroke DocumentIO::readStroke(const QJsonObject &object)
+{
+    const QString position = object.value("position").toString();
+    Stroke::StrokePosition strokePosition = Stroke::Center;
+    if(position == "inner") strokePosition = Stroke::Inner;
+    else if(position == "outer") strokePosition = Stroke::Outer;
+
+    const QString name = object.value("name").toString("stroke");
+    const qreal width = object.value("width").toDouble(1);
+
+    if(object.contains("gradient")){
+        return Stroke(name, readGradient(object.value("gradient").toObject()), width, strokePosition);
+    }
+
+    Stroke stroke(name, readColor(object.value("color")), width, strokePosition);
+
+    const QString style = object.value("style").toString();
+    if(style == "dash") stroke.setStyle(Qt::DashLine);
+    else if(style == "dot") stroke.setStyle(Qt::DotLine);
+
+    return stroke;
+}
+
+
+Shadow DocumentIO::readShadow(const QJsonObject &object)
+{
+    return Shadow(object.value("name").toString("shadow"),
+                  readColor(object.value("color"), QColor(0,0,0,128)),
+                  object.value("radius").toDouble(4),
+                  object.contains("offset") ? readPoint(object.value("offset")) : QPointF(0,2),
+                  object.value("spread").toDouble(0));
+}
+
+/*!
+ * \brief Reads a linear, radial or conical gradient. Stops are [position, color] pairs.
+ */
+Gradient DocumentIO::readGradient(const QJsonObject &object)
+{
+    const QString type = object.value("type").toString("linear");
+
+    QGradientStops stops;
+    foreach(QJsonValue value, object.value("stops").toArray()){
+        const QJsonArray stop = value.toArray();
+        stops.append(QGradientStop(stop.at(0).toDouble(), readColor(stop.at(1))));
+    }
+
+    const QString name = object.value("name").toString("gradient");
+
+    if(type == "radial"){
+        QRadialGradient radial(readPoint(object.value("center")), object.value("radius").toDouble(50));
+        radial.setStops(stops);
+        return Gradient(name, radial);
+    }
+
+    if(type == "conical"){
+        QConicalGradient conical(readPoint(object.value("center")), object.value("angle").toDouble());
+        conical.setStops(stops);
+        return Gradient(name, conical);
+    }
+
+    QLinearGradient linear(readPoint(object.value("start")), readPoint(object.value("end")));
+    linear.setStops(stops);
+    return Gradient(name, linear);
+}
+
+
+ExportLevel DocumentIO::readExportLevel(const QJsonObject &object, int id)
+{
+    const QString format = object.value("format").toString("png").toLower();
+    ExportLevel::FileFormat fileFormat = ExportLevel::PNG;
+    if(format == "jpg" || format == "jpeg") fileFormat = ExportLevel::JPG;
+    else if(format == "svg") fileFormat = ExportLevel::SVG;
+    else if(format == "pdf") fileFormat = ExportLevel::PDF;
+    else if(format == "atlas") fileFormat = ExportLevel::Atlas;
+
+    const ExportLevel::PathType pathType = (object.value("pathType").toString() == "prefix")
+            ? ExportLevel::prefix
+            : ExportLevel::suffix;
+
+    return ExportLevel(id, object.value("multiplier").toDouble(1), fileFormat, object.value("path").toString(), pathType);
+}
+
+
+Color DocumentIO::readColor(const QJsonValue &value, const QColor &fallback)
+{
+    const QColor color(value.toString());
+    return Color(color.isValid() ? color : fallback);
+}
+
+/*!
+ * \brief Reads [width, height] or [x, y, width, height].
+ */
+QRectF DocumentIO::readRect(const QJsonValue &value)
+{
+    const QJsonArray array = value.toArray();
+
+    if(array.count() == 4){
+        return QRectF(array.at(0).toDouble(), array.at(1).toDouble(), array.at(2).toDouble(), array.at(3).toDouble());
+    }
+
+    if(array.count() == 2){
+        return QRectF(0, 0, array.at(0).toDouble(), array.at(1).toDouble());
+    }
+
+    return QRectF(0, 0, 100, 100);
+}
+
+
+QPointF DocumentIO::readPoint(const QJsonValue &value)
+{
+    const QJsonArray array = value.toArray();
+    return QPointF(array.at(0).toDouble(), array.at(1).toDouble());
+}
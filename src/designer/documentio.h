@@ -0,0 +1,79 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef DOCUMENTIO_H
+#define DOCUMENTIO_H
+
+#include <QDir>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+
+#include <exportlevel.h>
+#include <fills.h>
+#include <shadow.h>
+#include <stroke.h>
+
+class AbstractItemBase;
+class Artboard;
+class CanvasScene;
+class ItemBase;
+
+/*!
+ * \brief Reads Draftoola JSON documents into a scene.
+ *
+ * A document holds a list of artboards, every artboard and item can hold child items:
+ * \code
+ * { "artboards": [ { "name": "Icon", "rect": [0, 0, 48, 48], "pos": [0, 0], "backgroundColor": "#ffffff",
+ *                    "exportLevels": [ { "multiplier": 2, "format": "png", "path": "@2x" } ],
+ *                    "items": [ { "type": "rect", "name": "Base", "rect": [0, 0, 48, 48], "radius": 8,
+ *                                 "fills": [ { "color": "#ff6803" } ] } ] } ] }
+ * \endcode
+ * Item types are rect, oval, polygon, star, text and group. Colors are strings understood by QColor.
+ */
+class DocumentIO
+{
+public:
+
+    static bool load(const QString &fileName, CanvasScene *scene, QString *errorMessage = nullptr);
+
+private:
+
+    static Artboard *readArtboard(const QJsonObject &object, const QDir &directory);
+    static AbstractItemBase *readItem(const QJsonObject &object, const QDir &directory);
+    static void readItemBase(const QJsonObject &object, ItemBase *item, const QDir &directory);
+    static void readCommon(const QJsonObject &object, AbstractItemBase *item);
+    static void readChildren(const QJsonObject &object, AbstractItemBase *parent, const QDir &directory);
+
+    static Fills readFills(const QJsonObject &object, const QDir &directory);
+    static Stroke readStroke(const QJsonObject &object);
+    static Shadow readShadow(const QJsonObject &object);
+    static Gradient readGradient(const QJsonObject &object);
+    static ExportLevel readExportLevel(const QJsonObject &object, int id);
+
+    static Color readColor(const QJsonValue &value, const QColor &fallback = Qt::black);
+    static QRectF readRect(const QJsonValue &value);
+    static QPointF readPoint(const QJsonValue &value);
+
+};
+
+#endif // DOCUMENTIO_H
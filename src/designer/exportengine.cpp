@@ -0,0 +1,886 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "exportengine.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPageSize>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QSaveFile>
+#include <QSvgGenerator>
+#include <QtConcurrent>
+#include <QtMath>
+
+#include <abstractitembase.h>
+#include <imagestreamwriter.h>
+#include <profiler.h>
+#include <rectpacker.h>
+
+// largest raster output rendered as one image (256 MB in ARGB32), larger outputs are streamed band by band
+static const qint64 MaxImagePixels = 64 * 1024 * 1024;
+
+// pixel budget of one render band
+static const qint64 BandPixels = 4 * 1024 * 1024;
+
+// file in the output directory that remembers the content hash of every written file
+static const QString ManifestFileName = ".draftoola-export.json";
+
+// maximum page size of atlases and space between their sprites
+static const QSize AtlasPageSize(2048, 2048);
+static const int AtlasPadding = 2;
+
+/***************************************************
+ *
+ * Constructor
+ *
+ ***************************************************/
+
+ExportEngine::ExportEngine(QObject *parent) : QObject(parent)
+{
+    m_running = false;
+    m_incremental = true;
+    m_manifestLoaded = false;
+    m_manifestChanged = false;
+
+    qRegisterMetaType<ExportEngine::Result>();
+
+    connect(&m_watcher, &QFutureWatcher<Result>::progressValueChanged, this, [this](int value){
+        emit progress(value, m_watcher.progressMaximum());
+    });
+
+    connect(&m_watcher, &QFutureWatcher<Result>::resultReadyAt, this, [this](int index){
+        const Result result = m_watcher.resultAt(index);
+        updateManifest(result);
+        emit itemExported(result);
+    });
+
+    connect(&m_watcher, &QFutureWatcher<Result>::finished, this, [this](){
+        const bool canceled = m_watcher.isCanceled();
+
+        if(!canceled && !m_queue.isEmpty()){
+            run();
+            return;
+        }
+
+        m_running = false;
+        saveManifest();
+        emit finished(canceled);
+    });
+}
+
+ExportEngine::~ExportEngine()
+{
+    m_queue.clear();
+    m_watcher.cancel();
+    m_watcher.waitForFinished();
+    saveManifest();
+}
+
+/***************************************************
+ *
+ * Properties
+ *
+ ***************************************************/
+
+/*!
+ * \brief Sets the directory export paths are relative to. Empty uses the working directory.
+ * \param directory
+ */
+void ExportEngine::setOutputDirectory(const QString &directory)
+{
+    if(directory == m_outputDirectory) return;
+
+    saveManifest();
+    m_manifest.clear();
+    m_manifestLoaded = false;
+
+    m_outputDirectory = directory;
+}
+
+QString ExportEngine::outputDirectory() const
+{
+    return m_outputDirectory;
+}
+
+/*!
+ * \brief Restricts exports to export levels of the given file formats. Empty exports all levels.
+ * \param formats
+ */
+void ExportEngine::setFileFormats(const QList<ExportLevel::FileFormat> &formats)
+{
+    m_fileFormats = formats;
+}
+
+QList<ExportLevel::FileFormat> ExportEngine::fileFormats() const
+{
+    return m_fileFormats;
+}
+
+/*!
+ * \brief Skips outputs whose content hash and path match the manifest of the output directory and whose file
+ * still exists. Enabled by default. The manifest is kept up to date in both modes.
+ * \param incremental
+ */
+void ExportEngine::setIncremental(bool incremental)
+{
+    m_incremental = incremental;
+}
+
+bool ExportEngine::isIncremental() const
+{
+    return m_incremental;
+}
+
+/*!
+ * \brief Returns true as long as queued or running jobs exist.
+ * \return
+ */
+bool ExportEngine::isRunning() const
+{
+    return m_running;
+}
+
+/***************************************************
+ *
+ * Members
+ *
+ ***************************************************/
+
+/*!
+ * \brief Records the items in their current state and queues them for export. Items can be changed or deleted
+ * right after the call, the export only works on the recording. Outputs that are unchanged since the last export
+ * into the output directory are reported as skipped without being recorded.
+ * \param items
+ */
+void ExportEngine::exportItems(const QList<AbstractItemBase *> &items)
+{
+    loadManifest();
+
+    // atlas levels of all items that target the same file at the same scale end up in one atlas
+    QMap<QString, Task> atlasTasks;
+    QMap<QString, QList<AbstractItemBase*> > atlasItems;
+
+    foreach(AbstractItemBase *item, items){
+        if(!item || item->exportLevels().isEmpty()) continue;
+
+        QList<Task> taskList;
+
+        foreach(const Task &task, tasks(item, m_outputDirectory, m_fileFormats)){
+            if(task.format == ExportLevel::FileFormat::Atlas){
+                const QString key = task.fileName + "@" + QString::number(task.multiplier);
+                if(!atlasTasks.contains(key)) atlasTasks.insert(key, task);
+                atlasItems[key].append(item);
+            }else{
+                taskList.append(task);
+            }
+        }
+
+        if(taskList.isEmpty()) continue;
+
+        Result skipped;
+        skipped.name = item->name();
+
+        taskList = changedTasks(item->contentHash(), taskList, skipped.skipped);
+
+        if(!taskList.isEmpty()) m_queue.append(record(item, taskList));
+        if(!skipped.skipped.isEmpty()) emit itemExported(skipped);
+    }
+
+    foreach(const QString &key, atlasTasks.keys()){
+        Task task = atlasTasks.value(key);
+
+        int scaleCount = 0;
+        foreach(const Task &other, atlasTasks){
+            if(other.fileName == task.fileName) scaleCount++;
+        }
+
+        // an atlas path used at several scales gets the scale appended, like "atlas@2x.json"
+        if(scaleCount > 1){
+            const QFileInfo info(task.fileName);
+            task.fileName = info.dir().filePath(info.completeBaseName() + "@" + QString::number(task.multiplier) + "x." + info.suffix());
+        }
+
+        queueAtlas(task, atlasItems.value(key));
+    }
+
+    if(m_running) return;
+
+    if(!m_queue.isEmpty()) run();
+    else emit finished(false);
+}
+
+/*!
+ * \brief Blocks until all queued jobs are written. Events are processed, so all signals are delivered.
+ */
+void ExportEngine::waitForFinished()
+{
+    while(m_running){
+        m_watcher.waitForFinished();
+        QCoreApplication::processEvents();
+    }
+}
+
+/*!
+ * \brief [SLOT] Drops queued jobs and stops the running batch after the items in progress.
+ */
+void ExportEngine::cancel()
+{
+    m_queue.clear();
+    m_watcher.cancel();
+}
+
+/*!
+ * \brief Returns the outputs of all export levels of an item.
+ * \param item
+ * \param directory output directory, empty uses the working directory
+ * \param formats file formats to export, empty exports all levels
+ * \return
+ */
+QList<ExportEngine::Task> ExportEngine::tasks(AbstractItemBase *item, const QString &directory, const QList<ExportLevel::FileFormat> &formats)
+{
+    QList<Task> taskList;
+
+    foreach(ExportLevel level, item->exportLevels()){
+
+        if(!formats.isEmpty() && !formats.contains(level.fileFormat())) continue;
+
+        Task task;
+        task.format = level.fileFormat();
+        task.multiplier = level.renderLevel();
+
+        const bool isVector = (task.format == ExportLevel::SVG || task.format == ExportLevel::PDF);
+        if(!isVector && task.multiplier <= 0) continue;
+
+        QString output = (level.pathType() == ExportLevel::PathType::prefix)
+                ? level.path() + item->name()
+                : item->name() + level.path();
+
+        // atlases are named by the path alone, the index file stands for all pages
+        if(task.format == ExportLevel::FileFormat::Atlas){
+            output = level.path().isEmpty() ? "atlas" : level.path();
+        }
+
+        switch(task.format){
+        case ExportLevel::FileFormat::JPG:
+            output += ".jpg";
+            break;
+        case ExportLevel::FileFormat::SVG:
+            output += ".svg";
+            break;
+        case ExportLevel::FileFormat::PDF:
+            output += ".pdf";
+            break;
+        case ExportLevel::FileFormat::Atlas:
+            output += ".json";
+            break;
+        default:
+        case ExportLevel::FileFormat::PNG:
+            output += ".png";
+            break;
+        }
+
+        task.fileName = directory.isEmpty() ? output : QDir(directory).filePath(output);
+
+        taskList.append(task);
+    }
+
+    return taskList;
+}
+
+/*!
+ * \brief Records an item for the given outputs. Has to run on the GUI thread, because it paints the item.
+ * \param item
+ * \param tasks
+ * \return
+ */
+ExportEngine::Job ExportEngine::record(AbstractItemBase *item, const QList<Task> &tasks)
+{
+    PROFILE_ITEM_SCOPE("ExportEngine::record", "export", item->name());
+
+    QElapsedTimer timer;
+    timer.start();
+
+    Job job;
+    job.name = item->name();
+    job.renderRect = item->renderRect();
+    job.tasks = tasks;
+
+    bool hasRaster = false;
+    bool hasBanded = false;
+    bool hasVector = false;
+    qreal bandedScale = 0;
+
+    foreach(const Task &task, tasks){
+        if(isRaster(task.format) && isBanded(job, task)){
+            bandedScale = qMax(bandedScale, task.multiplier);
+            hasBanded = true;
+        }else if(isRaster(task.format)){
+            job.scale = hasRaster ? qMax(job.scale, task.multiplier) : task.multiplier;
+            hasRaster = true;
+        }else{
+            hasVector = true;
+        }
+    }
+
+    // raster outputs share one recording at the highest scale
+    if(hasRaster){
+        DisplayListRecorder recorder;
+        QPainter painter(&recorder);
+        painter.scale(job.scale, job.scale);
+        painter.translate(-job.renderRect.topLeft());
+        item->render(&painter);
+        painter.end();
+
+        job.rasterList = recorder.displayList();
+    }
+
+    // banded outputs are recorded at a scale where rasters of the whole item, like blurred shadows,
+    // don't exceed one band. Paths and text stay sharp when the bands scale the recording up,
+    // shadow rasters get upscaled.
+    if(hasBanded){
+        const qreal area = job.renderRect.width() * job.renderRect.height();
+        job.bandScale = qMin(bandedScale, qSqrt(BandPixels / area));
+
+        DisplayListRecorder recorder;
+        QPainter painter(&recorder);
+        painter.scale(job.bandScale, job.bandScale);
+        painter.translate(-job.renderRect.topLeft());
+        item->render(&painter);
+        painter.end();
+
+        job.bandList = recorder.displayList();
+    }
+
+    if(hasVector){
+        DisplayListRecorder recorder;
+        QPainter painter(&recorder);
+        item->render(&painter);
+        painter.end();
+
+        job.vectorList = recorder.displayList();
+    }
+
+    job.recordNsecs = timer.nsecsElapsed();
+
+    return job;
+}
+
+/*!
+ * \brief Records an item as sprite of an atlas. Has to run on the GUI thread.
+ * \param item
+ * \param scale
+ * \return
+ */
+ExportEngine::Sprite ExportEngine::recordSprite(AbstractItemBase *item, qreal scale)
+{
+    PROFILE_ITEM_SCOPE("ExportEngine::recordSprite", "export", item->name());
+
+    const QRectF renderRect = item->renderRect();
+
+    Sprite sprite;
+    sprite.name = item->name();
+    sprite.size = QSize(qCeil(renderRect.width() * scale), qCeil(renderRect.height() * scale));
+
+    DisplayListRecorder recorder;
+    QPainter painter(&recorder);
+    painter.scale(scale, scale);
+    painter.translate(-renderRect.topLeft());
+    item->render(&painter);
+    painter.end();
+
+    sprite.list = recorder.displayList();
+
+    return sprite;
+}
+
+/*!
+ * \brief Writes all outputs of a job. Runs on a worker thread and only touches the job.
+ * \param job
+ * \return
+ */
+ExportEngine::Result ExportEngine::process(const Job &job)
+{
+    PROFILE_ITEM_SCOPE("ExportEngine::process", "export", job.name);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    Result result;
+    result.name = job.name;
+    result.recordNsecs = job.recordNsecs;
+
+    // outputs that fit into one band share a master image at the highest of their scales
+    qreal masterScale = 0;
+    foreach(const Task &task, job.tasks){
+        if(isRaster(task.format) && !isBanded(job, task)){
+            masterScale = qMax(masterScale, task.multiplier);
+        }
+    }
+
+    QImage master;
+
+    foreach(const Task &task, job.tasks){
+
+        bool written = false;
+
+        switch(task.format){
+        case ExportLevel::FileFormat::SVG:
+            written = writeSVG(job, task);
+            break;
+        case ExportLevel::FileFormat::PDF:
+            written = writePDF(job, task);
+            break;
+        case ExportLevel::FileFormat::Atlas:
+            written = writeAtlas(job, task, result.files);
+            break;
+        default:
+            if(isBanded(job, task)){
+                written = writeBanded(job, task);
+            }else{
+                if(master.isNull()) master = rasterize(job, masterScale);
+                written = writeImage(master, job, task);
+            }
+            break;
+        }
+
+        if(written) result.files.append(task.fileName);
+        else result.errors.append(task.fileName);
+    }
+
+    result.nsecs = timer.nsecsElapsed();
+
+    return result;
+}
+
+/***************************************************
+ *
+ * Private
+ *
+ ***************************************************/
+
+void ExportEngine::run()
+{
+    m_running = true;
+
+    QList<Job> jobs = m_queue;
+    m_queue.clear();
+
+    m_watcher.setFuture(QtConcurrent::mapped(jobs, &ExportEngine::process));
+}
+
+/*!
+ * \brief Removes the outputs that are up to date from the list and remembers the hashes of the others,
+ * so the manifest can be updated once they are written.
+ */
+QList<ExportEngine::Task> ExportEngine::changedTasks(const QByteArray &content, const QList<Task> &tasks, QStringList &skipped)
+{
+    QList<Task> changed;
+
+    foreach(const Task &task, tasks){
+
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(content);
+        hash.addData(QByteArray::number(int(task.format)));
+        hash.addData(QByteArray::number(task.multiplier, 'g', 17));
+        const QByteArray key = hash.result().toHex();
+
+        if(m_incremental && m_manifest.value(manifestPath(task.fileName)) == key && QFileInfo::exists(task.fileName)){
+            skipped.append(task.fileName);
+            continue;
+        }
+
+        m_pendingKeys.insert(task.fileName, key);
+        changed.append(task);
+    }
+
+    return changed;
+}
+
+
+/*!
+ * \brief Records all items of an atlas and queues it as one job, unless names and content of all items are unchanged.
+ */
+void ExportEngine::queueAtlas(const Task &task, const QList<AbstractItemBase *> &items)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    foreach(AbstractItemBase *item, items){
+        hash.addData(item->name().toUtf8());
+        hash.addData(item->contentHash());
+    }
+
+    Result skipped;
+    skipped.name = QFileInfo(task.fileName).completeBaseName();
+
+    if(changedTasks(hash.result(), {task}, skipped.skipped).isEmpty()){
+        emit itemExported(skipped);
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    Job job;
+    job.name = skipped.name;
+    job.scale = task.multiplier;
+    job.tasks.append(task);
+
+    foreach(AbstractItemBase *item, items){
+        job.sprites.append(recordSprite(item, task.multiplier));
+    }
+
+    job.recordNsecs = timer.nsecsElapsed();
+
+    m_queue.append(job);
+}
+
+
+QString ExportEngine::manifestPath(const QString &fileName) const
+{
+    return QDir(m_outputDirectory).relativeFilePath(fileName);
+}
+
+
+void ExportEngine::loadManifest()
+{
+    if(m_manifestLoaded) return;
+
+    m_manifestLoaded = true;
+    m_manifestChanged = false;
+    m_manifest.clear();
+
+    QFile file(QDir(m_outputDirectory).filePath(ManifestFileName));
+    if(!file.open(QIODevice::ReadOnly)) return;
+
+    const QJsonObject files = QJsonDocument::fromJson(file.readAll()).object().value("files").toObject();
+
+    for(auto it = files.constBegin(); it != files.constEnd(); ++it){
+        m_manifest.insert(it.key(), it.value().toString().toLatin1());
+    }
+}
+
+
+void ExportEngine::saveManifest()
+{
+    if(!m_manifestChanged) return;
+
+    QJsonObject files;
+    for(auto it = m_manifest.constBegin(); it != m_manifest.constEnd(); ++it){
+        files.insert(it.key(), QString::fromLatin1(it.value()));
+    }
+
+    QJsonObject manifest;
+    manifest.insert("version", 1);
+    manifest.insert("files", files);
+
+    QSaveFile file(QDir(m_outputDirectory).filePath(ManifestFileName));
+    if(!file.open(QIODevice::WriteOnly)) return;
+
+    file.write(QJsonDocument(manifest).toJson());
+    if(file.commit()) m_manifestChanged = false;
+}
+
+/*!
+ * \brief Stores the hashes of written files. Failed files are dropped, they have to be written again.
+ */
+void ExportEngine::updateManifest(const Result &result)
+{
+    foreach(QString fileName, result.files){
+        if(m_pendingKeys.contains(fileName)) m_manifest.insert(manifestPath(fileName), m_pendingKeys.take(fileName));
+    }
+
+    foreach(QString fileName, result.errors){
+        m_manifest.remove(manifestPath(fileName));
+        m_pendingKeys.remove(fileName);
+    }
+
+    m_manifestChanged = true;
+}
+
+
+bool ExportEngine::isRaster(ExportLevel::FileFormat format)
+{
+    return format == ExportLevel::FileFormat::PNG || format == ExportLevel::FileFormat::JPG;
+}
+
+/*!
+ * \brief Returns true if a raster output is too large to be allocated as one image and has to be streamed.
+ * Smaller outputs are never banded, because the band recording trades raster detail for memory.
+ */
+bool ExportEngine::isBanded(const Job &job, const Task &task)
+{
+    if(!ImageStreamWriter::isSupported()) return false;
+
+    const QSize size = (job.renderRect.size() * task.multiplier).toSize();
+
+    return qint64(size.width()) * size.height() > MaxImagePixels;
+}
+
+/*!
+ * \brief Replays the raster recording into an image. The recording was made at the job scale.
+ */
+QImage ExportEngine::rasterize(const Job &job, qreal scale)
+{
+    PROFILE_SCOPE("ExportEngine::rasterize", "export");
+
+    QImage image((job.renderRect.size() * scale).toSize(), QImage::Format_ARGB32_Premultiplied);
+    if(image.isNull()) return image;
+
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.scale(scale / job.scale, scale / job.scale);
+    job.rasterList.replay(&painter);
+    painter.end();
+
+    return image;
+}
+
+/*!
+ * \brief Renders the output in horizontal bands and streams each band into the encoder.
+ * The band recording holds no raster larger than one band, so peak memory is independent of the output resolution.
+ */
+bool ExportEngine::writeBanded(const Job &job, const Task &task)
+{
+    PROFILE_SCOPE("ExportEngine::writeBanded", "export");
+
+    const QSize size = (job.renderRect.size() * task.multiplier).toSize();
+    const bool isJPG = (task.format == ExportLevel::FileFormat::JPG);
+
+    ImageStreamWriter writer;
+    if(!writer.open(task.fileName, size, isJPG ? ImageStreamWriter::JPG : ImageStreamWriter::PNG)){
+        qWarning("ExportEngine: %s", qPrintable(writer.errorString()));
+        return false;
+    }
+
+    const int bandHeight = qBound(1, int(BandPixels / size.width()), size.height());
+
+    QImage band(size.width(), bandHeight, QImage::Format_ARGB32_Premultiplied);
+    if(band.isNull()) return false;
+
+    for(int top = 0; top < size.height(); top += bandHeight){
+
+        const int rowCount = qMin(bandHeight, size.height() - top);
+
+        band.fill(isJPG ? Qt::white : Qt::transparent);
+
+        QPainter painter(&band);
+        painter.setClipRect(0, 0, size.width(), rowCount);
+        painter.translate(0, -top);
+        painter.scale(task.multiplier / job.bandScale, task.multiplier / job.bandScale);
+        job.bandList.replay(&painter);
+        painter.end();
+
+        if(!writer.writeRows(band, rowCount)){
+            qWarning("ExportEngine: %s", qPrintable(writer.errorString()));
+            return false;
+        }
+    }
+
+    if(!writer.close()){
+        qWarning("ExportEngine: %s", qPrintable(writer.errorString()));
+        return false;
+    }
+
+    return true;
+}
+
+QImage ExportEngine::rasterizeSprite(const Sprite &sprite)
+{
+    PROFILE_ITEM_SCOPE("ExportEngine::rasterizeSprite", "export", sprite.name);
+
+    QImage image(sprite.size, QImage::Format_ARGB32_Premultiplied);
+    if(image.isNull()) return image;
+
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    sprite.list.replay(&painter);
+    painter.end();
+
+    return image;
+}
+
+/*!
+ * \brief Rasterizes all sprites in parallel, packs them into pages and writes the pages and a JSON index.
+ * The first page is named after the index, further pages get their number appended.
+ * \param job
+ * \param task task of the index file
+ * \param pages receives the written page files
+ * \return
+ */
+bool ExportEngine::writeAtlas(const Job &job, const Task &task, QStringList &pages)
+{
+    PROFILE_SCOPE("ExportEngine::writeAtlas", "export");
+
+    // runs on a pool thread, the blocking map lets this thread take part in the work
+    const QList<QImage> images = QtConcurrent::blockingMapped<QList<QImage> >(job.sprites, &ExportEngine::rasterizeSprite);
+
+    QList<QSize> sizes;
+    foreach(const QImage &image, images){
+        sizes.append(image.size());
+    }
+
+    const QList<RectPacker::Placement> placements = RectPacker::pack(sizes, AtlasPageSize, AtlasPadding);
+
+    // pages are cropped to the area covered by sprites
+    QList<QSize> pageSizes;
+    foreach(const RectPacker::Placement &placement, placements){
+        if(placement.page < 0) continue;
+        while(pageSizes.count() <= placement.page) pageSizes.append(QSize());
+        pageSizes[placement.page] = pageSizes[placement.page].expandedTo(QSize(placement.rect.right() + 1, placement.rect.bottom() + 1));
+    }
+
+    const QString baseName = QDir(QFileInfo(task.fileName).path()).filePath(QFileInfo(task.fileName).completeBaseName());
+
+    QJsonArray pageArray;
+
+    for(int p = 0; p < pageSizes.count(); ++p){
+
+        QImage page(pageSizes[p], QImage::Format_ARGB32_Premultiplied);
+        if(page.isNull()) return false;
+        page.fill(Qt::transparent);
+
+        QPainter painter(&page);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        for(int i = 0; i < placements.count(); ++i){
+            if(placements[i].page == p) painter.drawImage(placements[i].rect.topLeft(), images[i]);
+        }
+        painter.end();
+
+        const QString fileName = (p == 0) ? baseName + ".png" : baseName + "-" + QString::number(p) + ".png";
+        if(!page.save(fileName, "PNG")) return false;
+
+        pages.append(fileName);
+
+        QJsonObject pageObject;
+        pageObject["file"] = QFileInfo(fileName).fileName();
+        pageObject["width"] = page.width();
+        pageObject["height"] = page.height();
+        pageArray.append(pageObject);
+    }
+
+    QJsonArray spriteArray;
+
+    // empty sprites have no page and are left out of the index
+    for(int i = 0; i < placements.count(); ++i){
+        if(placements[i].page < 0) continue;
+
+        QJsonObject spriteObject;
+        spriteObject["name"] = job.sprites[i].name;
+        spriteObject["page"] = placements[i].page;
+        spriteObject["x"] = placements[i].rect.x();
+        spriteObject["y"] = placements[i].rect.y();
+        spriteObject["width"] = placements[i].rect.width();
+        spriteObject["height"] = placements[i].rect.height();
+        spriteArray.append(spriteObject);
+    }
+
+    QJsonObject index;
+    index["scale"] = task.multiplier;
+    index["pages"] = pageArray;
+    index["sprites"] = spriteArray;
+
+    QSaveFile file(task.fileName);
+    if(!file.open(QIODevice::WriteOnly)) return false;
+
+    file.write(QJsonDocument(index).toJson());
+
+    return file.commit();
+}
+
+/*!
+ * \brief Downsamples the master image to the scale of the task and encodes it. JPG gets a white background.
+ */
+bool ExportEngine::writeImage(const QImage &master, const Job &job, const Task &task)
+{
+    PROFILE_SCOPE("ExportEngine::writeImage", "export");
+
+    if(master.isNull()) return false;
+
+    const QSize size = (job.renderRect.size() * task.multiplier).toSize();
+    if(size.isEmpty()) return false;
+
+    QImage image = (size == master.size()) ? master : master.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    if(task.format == ExportLevel::FileFormat::JPG){
+        QImage opaque(image.size(), QImage::Format_RGB32);
+        opaque.fill(Qt::white);
+
+        QPainter painter(&opaque);
+        painter.drawImage(0, 0, image);
+        painter.end();
+
+        image = opaque;
+    }
+
+    return image.save(task.fileName, nullptr, 100);
+}
+
+
+bool ExportEngine::writeSVG(const Job &job, const Task &task)
+{
+    PROFILE_SCOPE("ExportEngine::writeSVG", "export");
+
+    QSvgGenerator generator;
+    generator.setFileName(task.fileName);
+    generator.setSize(job.renderRect.size().toSize());
+    generator.setViewBox(job.renderRect);
+    generator.setTitle(job.name);
+    generator.setDescription(tr("File created by ") + QCoreApplication::applicationName());
+    generator.setResolution(72);
+
+    QPainter painter;
+    if(!painter.begin(&generator)) return false;
+
+    job.vectorList.replay(&painter);
+
+    return painter.end();
+}
+
+
+bool ExportEngine::writePDF(const Job &job, const Task &task)
+{
+    PROFILE_SCOPE("ExportEngine::writePDF", "export");
+
+    QPdfWriter pdfWriter(task.fileName);
+    pdfWriter.setPageSize(QPageSize(QSizeF(job.renderRect.size()).toSize()));
+    pdfWriter.setTitle(job.name);
+    pdfWriter.setPageMargins(QMargins(0, 0, 0, 0));
+    pdfWriter.setResolution(72);
+    pdfWriter.setCreator(tr("File created by ") + QCoreApplication::applicationName());
+
+    QPainter painter;
+    if(!painter.begin(&pdfWriter)) return false;
+
+    painter.translate(-job.renderRect.topLeft());
+    job.vectorList.replay(&painter);
+
+    return painter.end();
+}
@@ -0,0 +1,156 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef EXPORTENGINE_H
+#define EXPORTENGINE_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QRectF>
+#include <QSize>
+#include <QStringList>
+
+#include <displaylist.h>
+#include <exportlevel.h>
+
+class AbstractItemBase;
+
+/*!
+ * \brief Exports items into all of their export levels on the thread pool.
+ * Items are recorded into display lists on the GUI thread, rasterization, encoding and file writing run on worker threads.
+ * Raster outputs of an item are rendered once at the highest scale and downsampled for the lower ones.
+ * Outputs larger than one band are rendered in horizontal bands and streamed into the encoder.
+ * A manifest in the output directory stores the content hash of every written file, unchanged outputs are skipped.
+ * Atlas levels of all exported items with the same path are packed into shared pages with a JSON index.
+ */
+class ExportEngine : public QObject
+{
+    Q_OBJECT
+public:
+
+    // one output file of an item
+    struct Task {
+        QString fileName;
+        ExportLevel::FileFormat format = ExportLevel::PNG;
+        qreal multiplier = 1;
+    };
+
+    // one item of an atlas, recorded at the scale of the atlas
+    struct Sprite {
+        QString name;
+        QSize size;
+        DisplayList list;
+    };
+
+    // immutable recording of one item with all its outputs, or of all sprites of an atlas
+    struct Job {
+        QString name;
+        QRectF renderRect;
+        qreal scale = 1;
+        qreal bandScale = 1;
+        DisplayList rasterList;
+        DisplayList bandList;
+        DisplayList vectorList;
+        QList<Task> tasks;
+        QList<Sprite> sprites;
+        qint64 recordNsecs = 0;
+    };
+
+    struct Result {
+        QString name;
+        QStringList files;
+        QStringList errors;
+        QStringList skipped;
+        qint64 recordNsecs = 0;
+        qint64 nsecs = 0;
+    };
+
+    ExportEngine(QObject *parent = nullptr);
+    ~ExportEngine();
+
+    void setOutputDirectory(const QString &directory);
+    QString outputDirectory() const;
+
+    void setFileFormats(const QList<ExportLevel::FileFormat> &formats);
+    QList<ExportLevel::FileFormat> fileFormats() const;
+
+    void setIncremental(bool incremental);
+    bool isIncremental() const;
+
+    void exportItems(const QList<AbstractItemBase*> &items);
+    bool isRunning() const;
+    void waitForFinished();
+
+    static QList<Task> tasks(AbstractItemBase *item, const QString &directory = QString(), const QList<ExportLevel::FileFormat> &formats = QList<ExportLevel::FileFormat>());
+    static Job record(AbstractItemBase *item, const QList<Task> &tasks);
+    static Sprite recordSprite(AbstractItemBase *item, qreal scale);
+    static Result process(const Job &job);
+
+public slots:
+    void cancel();
+
+signals:
+    void progress(int done, int total);
+    void itemExported(const ExportEngine::Result &result);
+    void finished(bool canceled);
+
+private:
+
+    QString m_outputDirectory;
+    QList<ExportLevel::FileFormat> m_fileFormats;
+    QList<Job> m_queue;
+    bool m_running;
+    QFutureWatcher<Result> m_watcher;
+
+    // content hashes of written files by path relative to the output directory
+    bool m_incremental;
+    bool m_manifestLoaded;
+    bool m_manifestChanged;
+    QHash<QString, QByteArray> m_manifest;
+    QHash<QString, QByteArray> m_pendingKeys;
+
+    void run();
+
+    QList<Task> changedTasks(const QByteArray &content, const QList<Task> &tasks, QStringList &skipped);
+    void queueAtlas(const Task &task, const QList<AbstractItemBase*> &items);
+    QString manifestPath(const QString &fileName) const;
+    void loadManifest();
+    void saveManifest();
+    void updateManifest(const Result &result);
+
+    static bool isRaster(ExportLevel::FileFormat format);
+    static bool isBanded(const Job &job, const Task &task);
+    static QImage rasterize(const Job &job, qreal scale);
+    static QImage rasterizeSprite(const Sprite &sprite);
+    static bool writeBanded(const Job &job, const Task &task);
+    static bool writeAtlas(const Job &job, const Task &task, QStringList &pages);
+    static bool writeImage(const QImage &master, const Job &job, const Task &task);
+    static bool writeSVG(const Job &job, const Task &task);
+    static bool writePDF(const Job &job, const Task &task);
+
+};
+
+Q_DECLARE_METATYPE(ExportEngine::Result)
+
+#endif // EXPORTENGINE_H
@@ -27,8 +27,10 @@
 
 #include <QDebug>
 #include <QtMath>
+#include <QElapsedTimer>
 
 #include <canvasscene.h>
+#include <profiler.h>
 
 ItemHandle::ItemHandle(QGraphicsItem *parent,  Handle corner, int handleSize, QColor color, Style style) :
     QGraphicsItem(parent),
@@ -226,8 +228,14 @@ HandleFrame::HandleFrame(CanvasScene *scene, qreal grid, int handleSize): QObjec
     m_canHeightChange(true),
     m_canWidthChange(true),
     m_color(QColor(0, 128, 255)),
-    m_canRotate(true)
+    m_canRotate(true),
+    m_inTransaction(false),
+    m_lastRebuildTime(0)
 {
+    // rebuild item geometry at most once per frame while dragging
+    m_rebuildTimer.setSingleShot(true);
+    m_rebuildTimer.setInterval(16);
+    connect(&m_rebuildTimer, &QTimer::timeout, this, &HandleFrame::applyTransform);
 
     m_handles[0] = new ItemHandle(this,ItemHandle::TopLeft, m_handleSize, m_color);
     m_handles[1] = new ItemHandle(this,ItemHandle::Top, m_handleSize, m_color);
@@ -531,8 +539,11 @@ bool HandleFrame::canHeightChange()
 
 void HandleFrame::adjustSize(qreal x, qreal y)
 {
-    m_oldRect = this->rect();
-    m_oldPos = this->scenePos();
+    // a transaction keeps the frame of the last geometry rebuild
+    if(!m_inTransaction){
+        m_oldRect = this->rect();
+        m_oldPos = this->scenePos();
+    }
 
     qreal m_width = this->width();
     qreal m_height = this->height();
@@ -606,6 +617,114 @@ void HandleFrame::updateItemsSelection()
 }
 
 
+/*!
+ * \brief Starts an interactive resize of all selected items. Items get cached as raster, which is scaled
+ * as preview until their geometry is rebuilt.
+ */
+void HandleFrame::beginTransform()
+{
+    if(m_inTransaction) return;
+
+    m_oldRect = this->rect();
+    m_oldPos = this->scenePos();
+    m_transaction.clear();
+
+    foreach(AbstractItemBase* item, m_items) {
+        TransformState state;
+        state.item = item;
+        state.transform = item->transform();
+        state.sceneTransform = item->sceneTransform();
+        state.cacheMode = item->cacheMode();
+        m_transaction.append(state);
+
+        item->setCacheMode(QGraphicsItem::ItemCoordinateCache);
+        item->beginInteractiveResize();
+    }
+
+    m_inTransaction = true;
+}
+
+
+/*!
+ * \brief Scales the cached item rasters from the frame of the last rebuild to the current frame.
+ */
+void HandleFrame::previewTransform()
+{
+    const qreal sx = this->width() / m_oldRect.width();
+    const qreal sy = this->height() / m_oldRect.height();
+
+    const QTransform frameMap = QTransform::fromTranslate(-m_oldPos.x(), -m_oldPos.y()) *
+            QTransform::fromScale(sx, sy) *
+            QTransform::fromTranslate(this->scenePos().x(), this->scenePos().y());
+
+    foreach(const TransformState &state, m_transaction) {
+        // item transform which moves the item in scene coordinates by frameMap
+        state.item->setTransform(state.sceneTransform * frameMap * state.sceneTransform.inverted() * state.transform);
+    }
+}
+
+
+/*!
+ * \brief Replaces the preview by the real item geometry.
+ */
+void HandleFrame::applyTransform()
+{
+    m_rebuildTimer.stop();
+
+    if(!m_inTransaction) return;
+
+    PROFILE_SCOPE("HandleFrame::applyTransform", "gui");
+
+    QElapsedTimer timer;
+    timer.start();
+
+    foreach(const TransformState &state, m_transaction) {
+        state.item->setTransform(state.transform);
+    }
+
+    updateItemsSelection();
+
+    m_oldRect = this->rect();
+    m_oldPos = this->scenePos();
+
+    for(int i = 0; i < m_transaction.size(); ++i){
+        m_transaction[i].sceneTransform = m_transaction.at(i).item->sceneTransform();
+    }
+
+    m_lastRebuildTime = timer.nsecsElapsed();
+    emit geometryRebuilt(m_transaction.size(), m_lastRebuildTime);
+}
+
+
+/*!
+ * \brief Completes the interactive resize. Items get their final geometry and cache mode back.
+ */
+void HandleFrame::endTransform()
+{
+    if(!m_inTransaction) return;
+
+    applyTransform();
+    m_inTransaction = false;
+
+    foreach(const TransformState &state, m_transaction) {
+        state.item->setCacheMode(state.cacheMode);
+        state.item->endInteractiveResize();
+    }
+
+    m_transaction.clear();
+}
+
+
+/*!
+ * \brief Returns the duration of the last geometry rebuild of an interactive resize in nanoseconds.
+ * \return
+ */
+qint64 HandleFrame::lastRebuildTime() const
+{
+    return m_lastRebuildTime;
+}
+
+
 /*!
  * \brief Reset HandleFrame to default values.
  */
@@ -613,6 +732,7 @@ void HandleFrame::reset()
 {
     this->setVisible(false);
     this->setRotation(0);
+    endTransform();
     m_items.clear();
 
     sendSignals();
@@ -824,9 +944,11 @@ bool HandleFrame::sceneEventFilter( QGraphicsItem * watched, QEvent * event )
         corner->mouseDownX = mevent->pos().x();
         corner->mouseDownY = mevent->pos().y();
         m_ratio = qMax(width() / height(), height() / width());
+        if(corner->getCorner() != ItemHandle::Rotate) beginTransform();
         break;
     case QEvent::GraphicsSceneMouseRelease:
         corner->setMouseState(ItemHandle::kMouseReleased);
+        endTransform();
         break;
     case QEvent::GraphicsSceneMouseMove:
         corner->setMouseState(ItemHandle::kMouseMoving );
@@ -976,8 +1098,14 @@ bool HandleFrame::sceneEventFilter( QGraphicsItem * watched, QEvent * event )
         // Set corner positions
         updateHandles();
 
-        // Update selected item sizes and positions
-        updateItemsSelection();
+        // Update selected item sizes and positions. During a transaction items show a scaled preview
+        // and the real geometry follows with the next frame.
+        if(m_inTransaction){
+            previewTransform();
+            if(!m_rebuildTimer.isActive()) m_rebuildTimer.start();
+        }else{
+            updateItemsSelection();
+        }
 
         this->update();
     }
@@ -1025,6 +1153,7 @@ void HandleFrame::mouseMoveEvent ( QGraphicsSceneMouseEvent * event )
 
 void HandleFrame::paint (QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *)
 {
+    PROFILE_SCOPE("HandleFrame::paint", "gui");
 
     Q_UNUSED(option)
 
@@ -38,6 +38,7 @@
 #include <QGraphicsDropShadowEffect>
 #include <QStyleOptionGraphicsItem>
 #include <QGraphicsItemGroup>
+#include <QTimer>
 
 #include <itembase.h>
 #include <itemrect.h>
@@ -177,6 +178,7 @@ public:
     void updateHandles();
     void setup();
     void rotateSelection(qreal angle);
+    qint64 lastRebuildTime() const;
 
 
 
@@ -204,6 +206,24 @@ private:
     bool        m_canRotate;
     QList<AbstractItemBase*> m_items;
 
+    // Transform transaction
+    struct TransformState {
+        AbstractItemBase *item;
+        QTransform transform;
+        QTransform sceneTransform;
+        QGraphicsItem::CacheMode cacheMode;
+    };
+
+    QList<TransformState> m_transaction;
+    bool        m_inTransaction;
+    QTimer      m_rebuildTimer;
+    qint64      m_lastRebuildTime;
+
+    void beginTransform();
+    void previewTransform();
+    void applyTransform();
+    void endTransform();
+
     void adjustSize(qreal x, qreal y);
     void updateItemGeometry(AbstractItemBase *item);
     void updateItemsSelection();
@@ -231,6 +251,7 @@ public slots:
 signals:
     void sendActiveItems(QList<AbstractItemBase *> items);
     void geometryChanged();
+    void geometryRebuilt(int items, qint64 nsecs);
 
 };
 
@@ -25,6 +25,7 @@
 
 #include "ruler.h"
 #include <QDebug>
+#include <profiler.h>
 
 /***************************************************
  *
@@ -143,6 +144,8 @@ void QDRuler::mouseMoveEvent(QMouseEvent *event)
 
 void QDRuler::paintEvent(QPaintEvent *)
 {
+    PROFILE_SCOPE("Ruler::paint", "gui");
+
     QPainter painter(this);
     QRectF rulerRect = this->rect();
 
@@ -0,0 +1,396 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "spatialindex.h"
+
+#include <algorithm>
+
+/***************************************************
+ *
+ * Helper
+ *
+ ***************************************************/
+
+/*!
+ * \brief Inclusive rect overlap test. QRectF::intersects() ignores rects without width or height, e.g. lines.
+ */
+static inline bool overlaps(const QRectF &a, const QRectF &b)
+{
+    return a.left() <= b.right() && b.left() <= a.right() &&
+            a.top() <= b.bottom() && b.top() <= a.bottom();
+}
+
+static inline bool containsPoint(const QRectF &rect, const QPointF &point)
+{
+    return rect.left() <= point.x() && point.x() <= rect.right() &&
+            rect.top() <= point.y() && point.y() <= rect.bottom();
+}
+
+static int itemDepth(const QGraphicsItem *item)
+{
+    int depth = 0;
+    while((item = item->parentItem())) depth++;
+    return depth;
+}
+
+
+/***************************************************
+ *
+ * Constructor
+ *
+ ***************************************************/
+
+SpatialIndex::SpatialIndex(const QRectF &worldRect, int maxDepth)
+{
+    // cells are square
+    qreal size = qMax(worldRect.width(), worldRect.height());
+    m_worldRect = QRectF(worldRect.topLeft(), QSizeF(size, size));
+    m_maxDepth = maxDepth;
+    m_sequence = 0;
+
+    m_root = new Node();
+    m_root->rect = m_worldRect;
+    m_root->looseRect = m_worldRect.adjusted(-size / 2, -size / 2, size / 2, size / 2);
+}
+
+SpatialIndex::~SpatialIndex()
+{
+    clear();
+    delete m_root;
+}
+
+
+/***************************************************
+ *
+ * Members
+ *
+ ***************************************************/
+
+void SpatialIndex::insert(QGraphicsItem *item, const QRectF &rect)
+{
+    if(m_entries.contains(item)){
+        update(item, rect);
+        return;
+    }
+
+    Entry *entry = new Entry();
+    entry->item = item;
+    entry->rect = rect.normalized();
+    entry->sequence = m_sequence++;
+
+    m_entries.insert(item, entry);
+    attach(entry, nodeFor(entry->rect));
+}
+
+
+/*!
+ * \brief Updates bounds of an indexed item. Items which stay in their cell are updated in place.
+ * \param item
+ * \param rect item bounds in scene coordinates
+ */
+void SpatialIndex::update(QGraphicsItem *item, const QRectF &rect)
+{
+    Entry *entry = m_entries.value(item, nullptr);
+
+    if(!entry){
+        insert(item, rect);
+        return;
+    }
+
+    entry->rect = rect.normalized();
+
+    if(entry->node == nodeFor(entry->rect)) return;
+
+    // detach before looking up the new cell, pruning must not delete freshly created cells
+    detach(entry);
+    attach(entry, nodeFor(entry->rect));
+}
+
+
+void SpatialIndex::remove(QGraphicsItem *item)
+{
+    Entry *entry = m_entries.take(item);
+    if(!entry) return;
+
+    detach(entry);
+    delete entry;
+}
+
+
+bool SpatialIndex::contains(QGraphicsItem *item) const
+{
+    return m_entries.contains(item);
+}
+
+
+void SpatialIndex::clear()
+{
+    qDeleteAll(m_entries);
+    m_entries.clear();
+
+    for(int i = 0; i < 4; ++i){
+        deleteNode(m_root->children[i]);
+        m_root->children[i] = nullptr;
+    }
+
+    m_root->entries.clear();
+    m_root->count = 0;
+}
+
+
+int SpatialIndex::size() const
+{
+    return m_entries.size();
+}
+
+
+/*!
+ * \brief Returns all items which bounds intersect the rect. The list is not sorted.
+ * \param rect
+ * \return
+ */
+QList<QGraphicsItem *> SpatialIndex::items(const QRectF &rect) const
+{
+    QList<QGraphicsItem*> result;
+    query(m_root, rect.normalized(), result);
+    return result;
+}
+
+
+/*!
+ * \brief Returns all items which bounds contain the point. The list is not sorted.
+ * \param point
+ * \return
+ */
+QList<QGraphicsItem *> SpatialIndex::items(const QPointF &point) const
+{
+    QList<QGraphicsItem*> result;
+    query(m_root, point, result);
+    return result;
+}
+
+
+/*!
+ * \brief Sorts items by stacking order like QGraphicsScene::items() does. DescendingOrder returns the top most item first.
+ * Top level items with the same z value are ordered by their insertion into the index.
+ * \param items
+ * \param order
+ */
+void SpatialIndex::sortByStackingOrder(QList<QGraphicsItem *> &items, Qt::SortOrder order) const
+{
+    QHash<const QGraphicsItem*, int> siblingIndex;
+
+    auto indexOf = [&](const QGraphicsItem *item) -> qint64 {
+        const QGraphicsItem *parent = item->parentItem();
+
+        if(!parent){
+            Entry *entry = m_entries.value(const_cast<QGraphicsItem*>(item), nullptr);
+            return (entry) ? static_cast<qint64>(entry->sequence) : -1;
+        }
+
+        if(!siblingIndex.contains(item)){
+            QList<QGraphicsItem*> children = parent->childItems();
+            for(int i = 0; i < children.size(); ++i){
+                siblingIndex.insert(children.at(i), i);
+            }
+        }
+        return siblingIndex.value(item);
+    };
+
+    // true if sibling a is on top of sibling b
+    auto closestLeaf = [&](const QGraphicsItem *a, const QGraphicsItem *b) -> bool {
+        bool behindA = a->flags() & QGraphicsItem::ItemStacksBehindParent;
+        bool behindB = b->flags() & QGraphicsItem::ItemStacksBehindParent;
+        if(behindA != behindB) return behindB;
+        if(a->zValue() != b->zValue()) return a->zValue() > b->zValue();
+        return indexOf(a) > indexOf(b);
+    };
+
+    // true if a is on top of b
+    auto closestFirst = [&](const QGraphicsItem *a, const QGraphicsItem *b) -> bool {
+        if(a == b) return false;
+        if(a->parentItem() == b->parentItem()) return closestLeaf(a, b);
+
+        int depthA = itemDepth(a);
+        int depthB = itemDepth(b);
+
+        const QGraphicsItem *ancestorA = a;
+        while(depthA > depthB){
+            ancestorA = ancestorA->parentItem();
+            if(ancestorA == b) return true; // children are drawn on top of their parents
+            depthA--;
+        }
+
+        const QGraphicsItem *ancestorB = b;
+        while(depthB > depthA){
+            ancestorB = ancestorB->parentItem();
+            if(ancestorB == a) return false;
+            depthB--;
+        }
+
+        while(ancestorA->parentItem() != ancestorB->parentItem()){
+            ancestorA = ancestorA->parentItem();
+            ancestorB = ancestorB->parentItem();
+        }
+
+        return closestLeaf(ancestorA, ancestorB);
+    };
+
+    if(order == Qt::DescendingOrder){
+        std::sort(items.begin(), items.end(), closestFirst);
+    }else{
+        std::sort(items.begin(), items.end(), [&](const QGraphicsItem *a, const QGraphicsItem *b){ return closestFirst(b, a); });
+    }
+}
+
+
+/***************************************************
+ *
+ * Private
+ *
+ ***************************************************/
+
+/*!
+ * \brief Returns the deepest cell which fits the rect, cells are created on demand.
+ * \param rect
+ * \return
+ */
+SpatialIndex::Node *SpatialIndex::nodeFor(const QRectF &rect)
+{
+    QPointF center = rect.center();
+    if(!m_worldRect.contains(center)) return m_root;
+
+    qreal size = qMax(rect.width(), rect.height());
+    qreal cellSize = m_worldRect.width();
+
+    Node *node = m_root;
+    int depth = 0;
+
+    while(depth < m_maxDepth && cellSize / 2 >= size){
+
+        QPointF mid = node->rect.center();
+        int quadrant = ((center.x() >= mid.x()) ? 1 : 0) | ((center.y() >= mid.y()) ? 2 : 0);
+
+        if(!node->children[quadrant]){
+            qreal half = cellSize / 2;
+            Node *child = new Node();
+            child->parent = node;
+            child->rect = QRectF(node->rect.left() + ((quadrant & 1) ? half : 0),
+                                 node->rect.top() + ((quadrant & 2) ? half : 0),
+                                 half, half);
+            child->looseRect = child->rect.adjusted(-half / 2, -half / 2, half / 2, half / 2);
+            node->children[quadrant] = child;
+        }
+
+        node = node->children[quadrant];
+        cellSize /= 2;
+        depth++;
+    }
+
+    return node;
+}
+
+
+void SpatialIndex::attach(Entry *entry, Node *node)
+{
+    entry->node = node;
+    entry->index = node->entries.size();
+    node->entries.append(entry);
+
+    for(Node *n = node; n; n = n->parent){
+        n->count++;
+    }
+}
+
+
+/*!
+ * \brief Removes entry from its cell and deletes cells which became empty.
+ * \param entry
+ */
+void SpatialIndex::detach(Entry *entry)
+{
+    Node *node = entry->node;
+
+    // swap remove
+    Entry *last = node->entries.takeLast();
+    if(last != entry){
+        node->entries[entry->index] = last;
+        last->index = entry->index;
+    }
+
+    for(Node *n = node; n; n = n->parent){
+        n->count--;
+    }
+
+    while(node != m_root && node->count == 0){
+        Node *parent = node->parent;
+        for(int i = 0; i < 4; ++i){
+            if(parent->children[i] == node) parent->children[i] = nullptr;
+        }
+        deleteNode(node); // empty cells below are gone as well
+        node = parent;
+    }
+
+    entry->node = nullptr;
+}
+
+
+void SpatialIndex::deleteNode(Node *node)
+{
+    if(!node) return;
+
+    for(int i = 0; i < 4; ++i){
+        deleteNode(node->children[i]);
+    }
+
+    delete node;
+}
+
+
+void SpatialIndex::query(const Node *node, const QRectF &rect, QList<QGraphicsItem *> &result) const
+{
+    if(!node || node->count == 0) return;
+    if(node != m_root && !overlaps(node->looseRect, rect)) return;
+
+    for(const Entry *entry : node->entries){
+        if(overlaps(entry->rect, rect)) result.append(entry->item);
+    }
+
+    for(int i = 0; i < 4; ++i){
+        query(node->children[i], rect, result);
+    }
+}
+
+
+void SpatialIndex::query(const Node *node, const QPointF &point, QList<QGraphicsItem *> &result) const
+{
+    if(!node || node->count == 0) return;
+    if(node != m_root && !containsPoint(node->looseRect, point)) return;
+
+    for(const Entry *entry : node->entries){
+        if(containsPoint(entry->rect, point)) result.append(entry->item);
+    }
+
+    for(int i = 0; i < 4; ++i){
+        query(node->children[i], point, result);
+    }
+}
@@ -0,0 +1,95 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <QGraphicsItem>
+#include <QHash>
+#include <QList>
+#include <QRectF>
+#include <QVector>
+
+/*!
+ * \brief Loose quadtree of item scene bounds. Every item is stored in the deepest cell which is at least as large as
+ * the item, found by its center. Cells overlap their neighbours by half their size, so no item has to be split or moved
+ * to a parent cell. Items outside of the world rect are kept in the root cell.
+ */
+class SpatialIndex
+{
+public:
+
+    SpatialIndex(const QRectF &worldRect = QRectF(-16000, -16000, 32000, 32000), int maxDepth = 12);
+    ~SpatialIndex();
+
+    void insert(QGraphicsItem *item, const QRectF &rect);
+    void update(QGraphicsItem *item, const QRectF &rect);
+    void remove(QGraphicsItem *item);
+    bool contains(QGraphicsItem *item) const;
+    void clear();
+    int size() const;
+
+    QList<QGraphicsItem*> items(const QRectF &rect) const;
+    QList<QGraphicsItem*> items(const QPointF &point) const;
+
+    void sortByStackingOrder(QList<QGraphicsItem*> &items, Qt::SortOrder order) const;
+
+private:
+
+    Q_DISABLE_COPY(SpatialIndex)
+
+    struct Node;
+
+    struct Entry {
+        QGraphicsItem *item = nullptr;
+        QRectF rect;
+        Node *node = nullptr;
+        int index = 0;
+        quint64 sequence = 0;
+    };
+
+    struct Node {
+        QRectF rect;
+        QRectF looseRect;
+        Node *parent = nullptr;
+        Node *children[4] = { nullptr, nullptr, nullptr, nullptr };
+        QVector<Entry*> entries;
+        int count = 0; // entries in subtree
+    };
+
+    Node *m_root;
+    QRectF m_worldRect;
+    int m_maxDepth;
+    quint64 m_sequence;
+    QHash<QGraphicsItem*, Entry*> m_entries;
+
+    Node *nodeFor(const QRectF &rect);
+    void attach(Entry *entry, Node *node);
+    void detach(Entry *entry);
+    void deleteNode(Node *node);
+
+    void query(const Node *node, const QRectF &rect, QList<QGraphicsItem*> &result) const;
+    void query(const Node *node, const QPointF &point, QList<QGraphicsItem*> &result) const;
+
+};
+
+#endif // SPATIALINDEX_H
@@ -0,0 +1,360 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "tilerenderer.h"
+
+#include <QPainter>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QtMath>
+
+#include <abstractitembase.h>
+#include <artboard.h>
+#include <profiler.h>
+
+// tile edge length in device pixels
+static const int TileSize = 256;
+// number of zoom levels kept in memory
+static const int MaxLevels = 3;
+// number of tiles per zoom level before invisible tiles get removed
+static const int MaxTiles = 256;
+
+TileRenderer::TileRenderer(QGraphicsScene *scene, QObject *parent) : QObject(parent)
+{
+    m_scene = scene;
+    m_snapshotScale = 0;
+    m_snapshotInvalid = true;
+
+    connect(m_scene, &QGraphicsScene::changed, this, &TileRenderer::invalidate);
+}
+
+TileRenderer::~TileRenderer()
+{
+    // items paint themselves again
+    foreach(QGraphicsItem *item, m_scene->items()){
+        AbstractItemBase *abItem = dynamic_cast<AbstractItemBase*>(item);
+        if(abItem) abItem->setTiled(false);
+    }
+}
+
+
+/***************************************************
+ *
+ * Members
+ *
+ ***************************************************/
+
+/*!
+ * \brief Draws cached tiles of the exposed area and requests missing or outdated tiles from the thread pool.
+ * Missing tiles are replaced by tiles of the previous zoom level until they are ready.
+ * \param painter painter in scene coordinates
+ * \param exposedRect
+ * \param scale zoom level of the view in device pixels, including the device pixel ratio
+ */
+void TileRenderer::paint(QPainter *painter, const QRectF &exposedRect, qreal scale)
+{
+    if(scale <= 0) return;
+
+    if(m_snapshotInvalid || scale != m_snapshotScale) updateSnapshot(scale);
+
+    m_levelOrder.removeAll(scale);
+    m_levelOrder.prepend(scale);
+    while(m_levelOrder.size() > MaxLevels){
+        m_levels.remove(m_levelOrder.takeLast());
+    }
+
+    QHash<quint64, Tile> &tiles = m_levels[scale];
+    QRect range = tileRange(exposedRect, scale);
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+
+    for(int y = range.top(); y <= range.bottom(); ++y){
+        for(int x = range.left(); x <= range.right(); ++x){
+
+            Tile &tile = tiles[tileKey(x, y)];
+            QRectF target(x * TileSize / scale, y * TileSize / scale, TileSize / scale, TileSize / scale);
+
+            if((tile.image.isNull() || tile.dirty) && !tile.pending) requestTile(scale, x, y);
+
+            if(!tile.image.isNull()){
+                painter->drawImage(target, tile.image);
+            }else drawFallback(painter, target);
+        }
+    }
+
+    painter->restore();
+
+    pruneTiles(tiles, range);
+}
+
+
+/*!
+ * \brief Drops all tiles and recorded items.
+ */
+void TileRenderer::clear()
+{
+    m_levels.clear();
+    m_levelOrder.clear();
+    m_snapshot.clear();
+    m_dirtyRegion.clear();
+    m_snapshotInvalid = true;
+}
+
+
+/*!
+ * \brief Returns true if the item is painted by tiles instead of the regular item paint path.
+ * \param item
+ * \return
+ */
+bool TileRenderer::isTiledItem(QGraphicsItem *item)
+{
+    return dynamic_cast<AbstractItemBase*>(item) != nullptr;
+}
+
+
+/*!
+ * \brief [SLOT] Marks tiles of all zoom levels in the changed scene region as outdated.
+ * \param region
+ */
+void TileRenderer::invalidate(const QList<QRectF> &region)
+{
+    if(region.isEmpty()) return;
+
+    m_dirtyRegion.append(region);
+    m_snapshotInvalid = true;
+
+    QMap<qreal, QHash<quint64, Tile>>::iterator level;
+    for(level = m_levels.begin(); level != m_levels.end(); ++level){
+        foreach(QRectF rect, region){
+            QRect range = tileRange(rect, level.key());
+
+            for(int y = range.top(); y <= range.bottom(); ++y){
+                for(int x = range.left(); x <= range.right(); ++x){
+                    QHash<quint64, Tile>::iterator tile = level.value().find(tileKey(x, y));
+                    if(tile != level.value().end()) tile->dirty = true;
+                }
+            }
+        }
+    }
+}
+
+
+/*!
+ * \brief Records all top level items which intersect the dirty region or all items if zoom level changed.
+ * Unchanged items keep their display list.
+ * \param scale
+ */
+void TileRenderer::updateSnapshot(qreal scale)
+{
+    bool rescaled = (scale != m_snapshotScale);
+    QTransform view = QTransform::fromScale(scale, scale);
+
+    QHash<QGraphicsItem*, Snapshot> previous;
+    foreach(Snapshot entry, m_snapshot){
+        previous.insert(entry.item, entry);
+    }
+
+    QVector<Snapshot> snapshot;
+
+    foreach(QGraphicsItem *item, m_scene->items(Qt::AscendingOrder)){
+        if(item->parentItem() || !isTiledItem(item) || !item->isVisible()) continue;
+
+        QRectF sceneRect = item->sceneBoundingRect().united(item->mapRectToScene(item->childrenBoundingRect()));
+
+        if(!rescaled && previous.contains(item)){
+            Snapshot entry = previous.value(item);
+            QRectF affected = entry.sceneRect.united(sceneRect);
+
+            bool dirty = false;
+            foreach(QRectF rect, m_dirtyRegion){
+                if(rect.intersects(affected)){
+                    dirty = true;
+                    break;
+                }
+            }
+
+            if(!dirty){
+                snapshot.append(entry);
+                continue;
+            }
+        }
+
+        DisplayListRecorder recorder;
+        QPainter painter(&recorder);
+        painter.setRenderHint(QPainter::TextAntialiasing, true);
+        DisplayListRecorder::recordItem(&painter, item, view);
+        painter.end();
+
+        // the view skips items which are part of the tiles
+        setTiled(item);
+
+        Snapshot entry;
+        entry.item = item;
+        entry.sceneRect = sceneRect;
+        entry.deviceRect = view.mapRect(sceneRect);
+        entry.displayList = recorder.displayList();
+        snapshot.append(entry);
+    }
+
+    m_snapshot = snapshot;
+    m_snapshotScale = scale;
+    m_snapshotInvalid = false;
+    m_dirtyRegion.clear();
+}
+
+
+/*!
+ * \brief Marks item and all document items below it as painted by tiles.
+ * \param item
+ */
+void TileRenderer::setTiled(QGraphicsItem *item)
+{
+    AbstractItemBase *abItem = dynamic_cast<AbstractItemBase*>(item);
+    if(abItem) abItem->setTiled(true);
+
+    foreach(QGraphicsItem *child, item->childItems()){
+        setTiled(child);
+    }
+}
+
+
+void TileRenderer::requestTile(qreal scale, int x, int y)
+{
+    quint64 key = tileKey(x, y);
+
+    Tile &tile = m_levels[scale][key];
+    tile.pending = true;
+    tile.dirty = false;
+
+    QFutureWatcher<QImage> *watcher = new QFutureWatcher<QImage>(this);
+
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, scale, key]{
+
+        if(m_levels.contains(scale)){
+            QHash<quint64, Tile> &tiles = m_levels[scale];
+            QHash<quint64, Tile>::iterator tile = tiles.find(key);
+
+            if(tile != tiles.end()){
+                tile->image = watcher->result();
+                tile->pending = false;
+            }
+        }
+
+        watcher->deleteLater();
+        emit tileReady();
+    });
+
+    watcher->setFuture(QtConcurrent::run(&TileRenderer::rasterize, m_snapshot, QRect(x * TileSize, y * TileSize, TileSize, TileSize)));
+}
+
+
+/*!
+ * \brief Draws tiles of the previous zoom level into the area of a missing tile.
+ * \param painter
+ * \param sceneRect
+ */
+void TileRenderer::drawFallback(QPainter *painter, const QRectF &sceneRect)
+{
+    if(m_levelOrder.size() < 2) return;
+
+    qreal scale = m_levelOrder.at(1);
+    const QHash<quint64, Tile> &tiles = m_levels[scale];
+    QRect range = tileRange(sceneRect, scale);
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter->setClipRect(sceneRect, Qt::IntersectClip);
+
+    for(int y = range.top(); y <= range.bottom(); ++y){
+        for(int x = range.left(); x <= range.right(); ++x){
+            QHash<quint64, Tile>::const_iterator tile = tiles.constFind(tileKey(x, y));
+            if(tile == tiles.constEnd() || tile->image.isNull()) continue;
+
+            QRectF target(x * TileSize / scale, y * TileSize / scale, TileSize / scale, TileSize / scale);
+            painter->drawImage(target, tile->image);
+        }
+    }
+
+    painter->restore();
+}
+
+
+void TileRenderer::pruneTiles(QHash<quint64, Tile> &tiles, const QRect &visibleTiles)
+{
+    if(tiles.size() <= MaxTiles) return;
+
+    QHash<quint64, Tile>::iterator tile = tiles.begin();
+    while(tile != tiles.end()){
+        int x = static_cast<qint32>(tile.key() >> 32);
+        int y = static_cast<qint32>(tile.key() & 0xffffffff);
+
+        if(!tile->pending && !visibleTiles.contains(x, y)){
+            tile = tiles.erase(tile);
+        }else ++tile;
+    }
+}
+
+
+/*!
+ * \brief Rasterizes one tile. Runs on a worker thread and only touches the immutable snapshot.
+ * \param snapshot
+ * \param tileRect tile area in device coordinates
+ * \return
+ */
+QImage TileRenderer::rasterize(const QVector<Snapshot> &snapshot, const QRect &tileRect)
+{
+    PROFILE_SCOPE("TileRenderer::rasterize", "tile");
+
+    QImage image(tileRect.size(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.translate(-tileRect.topLeft());
+
+    foreach(Snapshot entry, snapshot){
+        if(entry.deviceRect.intersects(tileRect)) entry.displayList.replay(&painter);
+    }
+
+    painter.end();
+
+    return image;
+}
+
+
+quint64 TileRenderer::tileKey(int x, int y)
+{
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
+
+
+/*!
+ * \brief Returns first and last tile index covering the scene rect.
+ * \param sceneRect
+ * \param scale
+ * \return
+ */
+QRect TileRenderer::tileRange(const QRectF &sceneRect, qreal scale)
+{
+    return QRect(QPoint(qFloor(sceneRect.left() * scale / TileSize), qFloor(sceneRect.top() * scale / TileSize)),
+                 QPoint(qFloor(sceneRect.right() * scale / TileSize), qFloor(sceneRect.bottom() * scale / TileSize)));
+}
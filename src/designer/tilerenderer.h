@@ -0,0 +1,89 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef TILERENDERER_H
+#define TILERENDERER_H
+
+#include <QObject>
+#include <QGraphicsScene>
+#include <QHash>
+#include <QMap>
+#include <QImage>
+
+#include <displaylist.h>
+
+class TileRenderer : public QObject
+{
+    Q_OBJECT
+public:
+    TileRenderer(QGraphicsScene *scene, QObject *parent = nullptr);
+    ~TileRenderer() override;
+
+    void paint(QPainter *painter, const QRectF &exposedRect, qreal scale);
+    void clear();
+
+    static bool isTiledItem(QGraphicsItem *item);
+
+signals:
+    void tileReady();
+
+public slots:
+    void invalidate(const QList<QRectF> &region);
+
+private:
+
+    struct Tile {
+        QImage image;
+        bool dirty = false;
+        bool pending = false;
+    };
+
+    // recorded top level item in device coordinates of the snapshot scale
+    struct Snapshot {
+        QGraphicsItem *item = nullptr;
+        QRectF sceneRect;
+        QRectF deviceRect;
+        DisplayList displayList;
+    };
+
+    QGraphicsScene *m_scene;
+    QVector<Snapshot> m_snapshot;
+    qreal m_snapshotScale;
+    bool m_snapshotInvalid;
+    QList<QRectF> m_dirtyRegion;
+
+    QMap<qreal, QHash<quint64, Tile>> m_levels;
+    QList<qreal> m_levelOrder;
+
+    void updateSnapshot(qreal scale);
+    void setTiled(QGraphicsItem *item);
+    void requestTile(qreal scale, int x, int y);
+    void drawFallback(QPainter *painter, const QRectF &sceneRect);
+    void pruneTiles(QHash<quint64, Tile> &tiles, const QRect &visibleTiles);
+
+    static QImage rasterize(const QVector<Snapshot> &snapshot, const QRect &tileRect);
+    static quint64 tileKey(int x, int y);
+    static QRect tileRange(const QRectF &sceneRect, qreal scale);
+
+};
+
+#endif // TILERENDERER_H
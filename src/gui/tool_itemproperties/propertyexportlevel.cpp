@@ -41,6 +41,7 @@ PropertyExportLevel::PropertyExportLevel(ExportLevel exportLevel, QWidget *paren
     fileFormatList->insert("JPG", ExportLevel::FileFormat::JPG);
     fileFormatList->insert("SVG", ExportLevel::FileFormat::SVG);
     fileFormatList->insert("PDF", ExportLevel::FileFormat::PDF);
+    fileFormatList->insert("Atlas", ExportLevel::FileFormat::Atlas);
 
     ui->comboFormat->addItems(QStringList(fileFormatList->keys()));
 
@@ -76,6 +77,9 @@ void PropertyExportLevel::setExportLevel(ExportLevel exportLevel)
     case ExportLevel::FileFormat::PDF:
             ui->comboFormat->setCurrentText("PDF");
         break;
+    case ExportLevel::FileFormat::Atlas:
+            ui->comboFormat->setCurrentText("Atlas");
+        break;
     default:
         break;
     }
@@ -126,6 +130,8 @@ void PropertyExportLevel::updateFill()
         fileFormat = ExportLevel::FileFormat::JPG;
     }else if(fileString == "PDF"){
         fileFormat = ExportLevel::FileFormat::PDF;
+    }else if(fileString == "Atlas"){
+        fileFormat = ExportLevel::FileFormat::Atlas;
     }if(fileString == "SVG"){
         fileFormat = ExportLevel::FileFormat::SVG;
     }
@@ -21,10 +21,12 @@
 **************************************************************************************/
 
 #include "abstractitembase.h"
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QPainter>
 #include <QtWidgets>
 #include <pathprocessor.h>
+#include <itemindex.h>
 
 AbstractItemBase::AbstractItemBase() : AbstractItemBase(QRect()){}
 AbstractItemBase::AbstractItemBase(const QRectF rect, QGraphicsItem *parent) : QGraphicsObject(parent)
@@ -35,8 +37,12 @@ AbstractItemBase::AbstractItemBase(const QRectF rect, QGraphicsItem *parent) : Q
     m_exportFactorList = QList<ExportLevel>();
     m_frameType = FrameType::Free;
     m_invaliateCache = true;
+    m_invalidations = InvalidateAll;
     m_doRender = false;
     m_isHovered = false;
+    m_interactiveResize = false;
+    m_tiled = false;
+    m_shapeRevision = 0;
 
     setRenderQuality(RenderQuality::Balanced);
 
@@ -67,8 +73,12 @@ AbstractItemBase::AbstractItemBase(const AbstractItemBase &other) : QGraphicsObj
     m_boundingRect = other.m_boundingRect;
     m_exportFactorList = other.m_exportFactorList;
     m_shape = other.m_shape;
+    m_shapeRevision = other.m_shapeRevision;
     m_invaliateCache = other.m_invaliateCache;
+    m_invalidations = other.m_invalidations;
     m_exportFactorList = other.m_exportFactorList;
+    m_interactiveResize = false;
+    m_tiled = false;
 
     this->setFlags(other.flags());
     this->setPos(other.pos());
@@ -77,6 +87,13 @@ AbstractItemBase::AbstractItemBase(const AbstractItemBase &other) : QGraphicsObj
 
 }
 
+AbstractItemBase::~AbstractItemBase()
+{
+    // itemChange() is not called for items which get deleted while they are in a scene
+    ItemIndex *index = dynamic_cast<ItemIndex*>(scene());
+    if(index) index->unindexItem(this);
+}
+
 
 
 /***************************************************
@@ -115,10 +132,194 @@ bool AbstractItemBase::invalidateCache() const
     return m_invaliateCache;
 }
 
+/*!
+ * \brief Marks parts of the item as outdated. Geometry is recalculated lazily by ensureGeometry() before
+ * the next paint or bounding rect request. Any geometry change also outdates the recorded paint.
+ * \param flags
+ */
+void AbstractItemBase::invalidate(Invalidations flags)
+{
+    if(flags & InvalidateGeometry) flags |= InvalidatePaint;
+
+    if(flags.testFlag(InvalidateBounds) && !m_invalidations.testFlag(InvalidateBounds)){
+        prepareGeometryChange();
+    }
+
+    m_invalidations |= flags;
+
+    if(flags.testFlag(InvalidateBounds)) updateIndex(false);
+
+    notifyParent();
+    update();
+}
+
+AbstractItemBase::Invalidations AbstractItemBase::invalidations() const
+{
+    return m_invalidations;
+}
+
+/*!
+ * \brief Recalculates outdated geometry.
+ */
+void AbstractItemBase::ensureGeometry() const
+{
+    if(m_invalidations & InvalidateGeometry){
+        const_cast<AbstractItemBase*>(this)->calculateGeometry();
+    }
+}
+
+/*!
+ * \brief Starts a resize by the user. Until endInteractiveResize() is called items may skip
+ * expensive derived geometry and update it once at the end.
+ */
+void AbstractItemBase::beginInteractiveResize()
+{
+    m_interactiveResize = true;
+}
+
+/*!
+ * \brief Ends a resize by the user and recalculates all derived geometry.
+ */
+void AbstractItemBase::endInteractiveResize()
+{
+    if(!m_interactiveResize) return;
+
+    m_interactiveResize = false;
+    setInvalidateCache(true);
+    invalidate(InvalidateAll);
+}
+
+bool AbstractItemBase::isInteractiveResize() const
+{
+    return m_interactiveResize;
+}
+
+/*!
+ * \brief Marks the item as part of the tiles of the view. Tiled items skip paint calls of the view,
+ * calls without widget like recordings and exports still paint.
+ * \param tiled
+ */
+void AbstractItemBase::setTiled(bool tiled)
+{
+    m_tiled = tiled;
+}
+
+bool AbstractItemBase::isTiled() const
+{
+    return m_tiled;
+}
+
+/*!
+ * \brief Clears invalidation flags once the related data is up to date.
+ * \param flags
+ */
+void AbstractItemBase::validate(Invalidations flags)
+{
+    m_invalidations &= ~flags;
+}
+
+/*!
+ * \brief Recalculates all derived geometry. Items with bounds depending on properties override it.
+ */
+void AbstractItemBase::calculateGeometry()
+{
+    validate(InvalidateGeometry);
+}
+
+/*!
+ * \brief Keeps the spatial index of the scene up to date.
+ */
+QVariant AbstractItemBase::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    switch(change){
+    case ItemSceneChange:{
+        ItemIndex *index = dynamic_cast<ItemIndex*>(scene());
+        if(index) index->unindexItem(this);
+        break;
+    }
+    case ItemParentChange:
+        // item leaves its current artboard
+        notifyParent();
+        break;
+    case ItemSceneHasChanged:
+    case ItemVisibleHasChanged:
+        updateIndex(false);
+        notifyParent();
+        break;
+    case ItemPositionHasChanged:
+    case ItemTransformHasChanged:
+    case ItemRotationHasChanged:
+    case ItemScaleHasChanged:
+    case ItemParentHasChanged:
+        // scene bounds of all children move with their parent
+        updateIndex(true);
+        notifyParent();
+        break;
+    default:
+        break;
+    }
+
+    return QGraphicsObject::itemChange(change, value);
+}
+
+/*!
+ * \brief Called when an item below this item changed. Forwards the change to the parent item,
+ * items caching the look of their children override it.
+ */
+void AbstractItemBase::childChanged()
+{
+    notifyParent();
+}
+
+/*!
+ * \brief Tells the closest parent item that this item changed. Helper items in between are skipped.
+ */
+void AbstractItemBase::notifyParent()
+{
+    QGraphicsItem *parent = parentItem();
+
+    while(parent){
+        AbstractItemBase *item = dynamic_cast<AbstractItemBase*>(parent);
+        if(item){
+            item->childChanged();
+            return;
+        }
+        parent = parent->parentItem();
+    }
+}
+
+/*!
+ * \brief Marks the item and optionally its children as outdated in the spatial index.
+ * \param recursive
+ */
+void AbstractItemBase::updateIndex(bool recursive)
+{
+    ItemIndex *index = dynamic_cast<ItemIndex*>(scene());
+    if(!index) return;
+
+    index->indexItem(this);
+
+    if(!recursive) return;
+
+    foreach(QGraphicsItem *child, QGraphicsItem::childItems()){
+        AbstractItemBase *item = dynamic_cast<AbstractItemBase*>(child);
+        if(item){
+            item->updateIndex(true);
+        }else{
+            // ArtboardCanvas and other helper items in between
+            foreach(QGraphicsItem *grandChild, child->childItems()){
+                AbstractItemBase *subItem = dynamic_cast<AbstractItemBase*>(grandChild);
+                if(subItem) subItem->updateIndex(true);
+            }
+        }
+    }
+}
+
 
 void AbstractItemBase::setShape(QPainterPath itemShape)
 {
     m_shape = itemShape;
+    m_shapeRevision++;
     m_rect = m_shape.boundingRect().normalized();
     setInvalidateCache(true);
     setTransformOriginPoint(m_rect.center());
@@ -126,7 +327,7 @@ void AbstractItemBase::setShape(QPainterPath itemShape)
     //    emit this->widthChanged();
     //    emit this->heightChanged();
 
-    update();
+    invalidate(InvalidateAll);
 }
 
 /*!
@@ -138,6 +339,31 @@ QPainterPath AbstractItemBase::shape() const
     return m_shape;
 }
 
+/*!
+ * \brief Return revision of the shape. It increases with every setShape() call and can be used as cache key for derived geometry.
+ * \return
+ */
+quint64 AbstractItemBase::shapeRevision() const
+{
+    return m_shapeRevision;
+}
+
+/*!
+ * \brief Return hash over everything that affects the rendered output of the item and its children.
+ * Equal hashes produce equal exports. ID, name and position of the item itself are not part of it.
+ * \return
+ */
+QByteArray AbstractItemBase::contentHash() const
+{
+    QByteArray content;
+    QDataStream stream(&content, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    writeContent(stream);
+
+    return QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+}
+
 /*!
  * \brief Return a rectangle that covers only the base shape of the object.
  * \return
@@ -153,6 +379,7 @@ QRectF AbstractItemBase::rect() const
  */
 QRectF AbstractItemBase::boundingRect() const
 {
+    ensureGeometry();
     return m_boundingRect;
 }
 
@@ -380,6 +607,24 @@ bool AbstractItemBase::operator==(const AbstractItemBase &other) const
 
 }
 
+/*!
+ * \brief Writes the render relevant properties for contentHash(). Subclasses append their own properties.
+ * Children contribute their position and hash.
+ * \param stream
+ */
+void AbstractItemBase::writeContent(QDataStream &stream) const
+{
+    stream << type() <<
+              m_rect <<
+              (int)m_frameType <<
+              m_shape <<
+              transform();
+
+    foreach(AbstractItemBase *child, childItems()){
+        stream << child->pos() << child->contentHash();
+    }
+}
+
 
 QDebug operator<<(QDebug dbg, const AbstractItemBase &obj)
 {
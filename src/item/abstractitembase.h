@@ -69,11 +69,24 @@ public:
         Quality = 2
     };
 
+    enum Invalidation {
+        InvalidateNone = 0x00,
+        InvalidateShape = 0x01,
+        InvalidateStrokeGeometry = 0x02,
+        InvalidateShadowGeometry = 0x04,
+        InvalidatePaint = 0x08,
+        InvalidateBounds = 0x10,
+        InvalidateGeometry = InvalidateShape | InvalidateStrokeGeometry | InvalidateShadowGeometry | InvalidateBounds,
+        InvalidateAll = InvalidateGeometry | InvalidatePaint
+    };
+    Q_DECLARE_FLAGS(Invalidations, Invalidation)
+
 
     // Constructor
     AbstractItemBase();
     AbstractItemBase(const QRectF rect, QGraphicsItem *parent = nullptr);
     AbstractItemBase(const AbstractItemBase &other);
+    ~AbstractItemBase();
 
 
     // operator
@@ -96,6 +109,8 @@ public:
 
     virtual void setShape(QPainterPath itemShape);
     virtual QPainterPath shape() const override;
+    quint64 shapeRevision() const;
+    QByteArray contentHash() const;
 
     virtual void setRect(QRectF rect) = 0;
     virtual QRectF rect() const;
@@ -113,6 +128,17 @@ public:
     void setInvalidateCache(bool invalidate);
     bool invalidateCache() const;
 
+    void invalidate(Invalidations flags);
+    Invalidations invalidations() const;
+    void ensureGeometry() const;
+
+    virtual void beginInteractiveResize();
+    virtual void endInteractiveResize();
+    bool isInteractiveResize() const;
+
+    void setTiled(bool tiled);
+    bool isTiled() const;
+
     QPointF anchorTopLeft() const;
     QPointF anchorTop() const;
     QPointF anchorTopRight() const;
@@ -145,6 +171,14 @@ public:
 //public slots:
     void setRenderQuality(RenderQuality qualityLevel);
 
+protected:
+
+    virtual void calculateGeometry();
+    virtual void writeContent(QDataStream &stream) const;
+    virtual void childChanged();
+    void validate(Invalidations flags);
+    QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
+
 
 private:
 
@@ -155,15 +189,24 @@ private:
     FrameType m_frameType;
     QString m_name;
     bool m_invaliateCache;
+    Invalidations m_invalidations;
     qreal m_lod;
     RenderQuality m_renderQuality;
     QPainterPath m_shape;
+    quint64 m_shapeRevision;
     bool m_doRender;
     bool m_isHovered;
+    bool m_interactiveResize;
+    bool m_tiled;
 
     // Members
     QList<ExportLevel>	m_exportFactorList;
 
+    void updateIndex(bool recursive);
+    void notifyParent();
+
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(AbstractItemBase::Invalidations)
+
 #endif // ABSTRACTITEMBASE_H
@@ -24,6 +24,22 @@
 #include <QDebug>
 #include <QFont>
 #include <QGraphicsDropShadowEffect>
+#include <skiarenderer.h>
+#include <qt2skia.h>
+#include <skia_includes.h>
+#include <lodpolicy.h>
+#include <displaylist.h>
+#include <profiler.h>
+#include <QFutureWatcher>
+#include <QTimer>
+#include <QtConcurrent>
+#include <QtMath>
+
+// zoom buckets kept per artboard
+static const int MaxSnapshots = 2;
+// snapshots are used up to 100% zoom, closer views paint the items
+static const qreal MaxSnapshotScale = 1.0;
+static const qreal MinSnapshotScale = 1.0 / 64;
 
 /*********************
  *
@@ -71,6 +87,9 @@ Artboard::Artboard(QString name, QRectF rect, QGraphicsItem *parent) : AbstractI
     m_buffer = 4;
     m_backgroundColor = Qt::white;
     m_useBGColor = true;
+    m_revision = 1;
+    m_snapshotActive = false;
+    m_recordingSnapshot = false;
 
     m_artboard = new ArtboardCanvas(rect, this);
     m_artboard->setFlags(
@@ -105,6 +124,9 @@ Artboard::Artboard(const Artboard &other) : AbstractItemBase(other)
     m_backgroundColor = other.m_backgroundColor;
     m_label = other.m_label;
     m_artboard = other.m_artboard;
+    m_revision = 1;
+    m_snapshotActive = false;
+    m_recordingSnapshot = false;
 }
 
 
@@ -141,6 +163,7 @@ void Artboard::setRect(QRectF rect)
     AbstractItemBase::setShape(shape);
     m_artboard->setRect(rect);
     m_artboard->update();
+    invalidateSnapshot();
 }
 
 
@@ -184,6 +207,7 @@ QRectF Artboard::renderRect() const
 void Artboard::setBackgroundColor(const QColor color)
 {
     m_backgroundColor = color;
+    invalidateSnapshot();
 }
 
 QColor Artboard::backgroundColor() const
@@ -194,6 +218,7 @@ QColor Artboard::backgroundColor() const
 void Artboard::setUseBackgroundColor(bool useBGColor)
 {
     m_useBGColor = useBGColor;
+    invalidateSnapshot();
 }
 
 bool Artboard::useBackgroundColor() const
@@ -202,6 +227,34 @@ bool Artboard::useBackgroundColor() const
 }
 
 
+/*!
+ * \brief Returns true if the last paint call composited the snapshot in place of the items.
+ * \return
+ */
+bool Artboard::isSnapshotActive() const
+{
+    return m_snapshotActive && !m_recordingSnapshot;
+}
+
+/*!
+ * \brief Marks all snapshots as outdated. Called whenever one of the items on the artboard changes.
+ */
+void Artboard::invalidateSnapshot()
+{
+    if(m_recordingSnapshot) return;
+
+    m_revision++;
+}
+
+/*!
+ * \brief Items on the artboard changed, the snapshots don't show them anymore.
+ */
+void Artboard::childChanged()
+{
+    invalidateSnapshot();
+}
+
+
 /***************************************************
  *
  * Events
@@ -210,10 +263,6 @@ bool Artboard::useBackgroundColor() const
 
 void Artboard::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
-    Q_UNUSED(widget);
-
-    if(m_useBGColor) painter->fillRect(renderRect(), QBrush(m_backgroundColor));
-
     m_lod = option->levelOfDetailFromTransform( painter->transform());
 
     if(!m_doRender){
@@ -225,7 +274,20 @@ void Artboard::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
             m_label->show();
         }else m_label->hide();
 
+        // the view shows tiled artboards by tiles, recordings for the tiles pass no widget
+        if(isTiled() && widget) return;
+
+        m_snapshotActive = paintSnapshot(painter);
+        if(m_snapshotActive) return;
+    }
+
+    // exports and recordings always get QPainter commands
+    if(!m_doRender && SkiaRenderer::isTarget(painter) &&
+            SkiaRenderer::render(painter, renderRect(), [this](SkCanvas *canvas){ paintSkia(canvas); })) return;
 
+    if(m_useBGColor) painter->fillRect(renderRect(), QBrush(m_backgroundColor));
+
+    if(!m_doRender){
         QPen pen = QPen(QColor(200,200,200));
         pen.setCosmetic(true);
 
@@ -236,6 +298,172 @@ void Artboard::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
 
 }
 
+void Artboard::paintSkia(SkCanvas *canvas)
+{
+    SkPaint background;
+    background.setColor(skia::skColor(m_backgroundColor));
+
+    if(m_useBGColor) canvas->drawRect(skia::skRect(renderRect()), background);
+
+    if(!m_doRender){
+        // hairline frame, same as the cosmetic pen
+        SkPaint frame;
+        frame.setStyle(SkPaint::kStroke_Style);
+        frame.setStrokeWidth(0);
+        frame.setColor(skia::skColor(QColor(200,200,200)));
+
+        canvas->drawRect(skia::skRect(rect()), background);
+        canvas->drawRect(skia::skRect(rect()), frame);
+    }
+}
+
+/*!
+ * \brief Composites the snapshot of the current zoom bucket instead of painting all items, as long as the artboard
+ * is not edited. Outdated snapshots are rebuilt in the background while the items paint themselves.
+ * At the thumbnail tier an outdated snapshot is drawn until the new one is ready.
+ * \param painter
+ * \return true if the snapshot was drawn
+ */
+bool Artboard::paintSnapshot(QPainter *painter)
+{
+    // snapshots are rasterized in device pixels
+    const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    const qreal deviceLod = m_lod * dpr;
+
+    if(m_recordingSnapshot || rect().isEmpty() || deviceLod > MaxSnapshotScale) return false;
+
+    const bool thumbnail = LodPolicy::tier(m_lod, renderQuality()) == LodPolicy::Thumbnail;
+    if(!thumbnail && isEdited()) return false;
+
+    const qreal scale = snapshotScale(deviceLod);
+
+    m_snapshotOrder.removeAll(scale);
+    m_snapshotOrder.prepend(scale);
+    while(m_snapshotOrder.size() > MaxSnapshots){
+        m_snapshots.remove(m_snapshotOrder.takeLast());
+    }
+
+    Snapshot &snapshot = m_snapshots[scale];
+    const bool valid = (snapshot.revision == m_revision);
+
+    // recording paints all items, so it runs after the current frame and not inside of the paint pass
+    if(!valid && !snapshot.pending){
+        snapshot.pending = true;
+        QTimer::singleShot(0, this, [this, scale]{ requestSnapshot(scale); });
+    }
+
+    if(snapshot.image.isNull() || (!valid && !thumbnail)) return false;
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter->drawImage(rect(), snapshot.image);
+
+    QPen pen = QPen(QColor(200,200,200));
+    pen.setCosmetic(true);
+
+    painter->setBrush(Qt::NoBrush);
+    painter->setPen(pen);
+    painter->drawRect(this->rect());
+    painter->restore();
+
+    return true;
+}
+
+/*!
+ * \brief Records background and items of the artboard on the GUI thread and rasterizes the recording on the thread pool.
+ * \param scale zoom bucket
+ */
+void Artboard::requestSnapshot(qreal scale)
+{
+    // the zoom bucket may have been dropped since the request was scheduled
+    if(!m_snapshots.contains(scale)) return;
+
+    PROFILE_SCOPE("Artboard::recordSnapshot", "artboard");
+
+    const QSize size = (rect().size() * scale).toSize().expandedTo(QSize(1, 1));
+    const QTransform view = QTransform::fromTranslate(-rect().left(), -rect().top()) *
+            QTransform::fromScale(size.width() / rect().width(), size.height() / rect().height());
+
+    DisplayListRecorder recorder;
+    QPainter painter(&recorder);
+    painter.setRenderHint(QPainter::TextAntialiasing, true);
+    painter.setTransform(view);
+
+    if(m_useBGColor) painter.fillRect(rect(), m_backgroundColor);
+
+    // items invalidate while they paint, which must not outdate the snapshot in progress
+    m_recordingSnapshot = true;
+    DisplayListRecorder::recordItem(&painter, m_artboard, sceneTransform().inverted() * view);
+    m_recordingSnapshot = false;
+
+    painter.end();
+
+    m_snapshots[scale].pending = true;
+    const quint64 revision = m_revision;
+
+    QFutureWatcher<QImage> *watcher = new QFutureWatcher<QImage>(this);
+
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, scale, revision]{
+
+        QMap<qreal, Snapshot>::iterator snapshot = m_snapshots.find(scale);
+
+        if(snapshot != m_snapshots.end()){
+            snapshot->image = watcher->result();
+            snapshot->revision = revision;
+            snapshot->pending = false;
+            update();
+        }
+
+        watcher->deleteLater();
+    });
+
+    watcher->setFuture(QtConcurrent::run(&Artboard::rasterize, recorder.displayList(), size));
+}
+
+/*!
+ * \brief Returns true if one of the items on the artboard is selected.
+ * \return
+ */
+bool Artboard::isEdited() const
+{
+    if(!scene()) return false;
+
+    foreach(QGraphicsItem *item, scene()->selectedItems()){
+        if(isAncestorOf(item)) return true;
+    }
+
+    return false;
+}
+
+/*!
+ * \brief Returns the zoom bucket of a level of detail. Buckets are powers of two, so snapshots are only scaled down.
+ * \param lod
+ * \return
+ */
+qreal Artboard::snapshotScale(qreal lod)
+{
+    if(lod <= 0) return MinSnapshotScale;
+
+    return qBound(MinSnapshotScale, qPow(2.0, qCeil(std::log2(lod))), MaxSnapshotScale);
+}
+
+/*!
+ * \brief Replays the recorded artboard. Runs on a worker thread and only touches the display list.
+ */
+QImage Artboard::rasterize(const DisplayList &displayList, const QSize &size)
+{
+    PROFILE_SCOPE("Artboard::rasterize", "artboard");
+
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    displayList.replay(&painter);
+    painter.end();
+
+    return image;
+}
+
 void Artboard::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 {
     QGraphicsItem::mouseReleaseEvent(event);
@@ -267,6 +495,14 @@ bool Artboard::operator==(const Artboard &other) const
             AbstractItemBase::operator==(other);
 }
 
+void Artboard::writeContent(QDataStream &stream) const
+{
+    AbstractItemBase::writeContent(stream);
+
+    stream << m_useBGColor <<
+              m_backgroundColor;
+}
+
 void Artboard::fromObject(AbstractItemBase *obj)
 {
     m_id = obj->m_id;
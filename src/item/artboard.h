@@ -28,13 +28,17 @@
 #include <QStyleOptionGraphicsItem>
 #include <QPen>
 #include <QPainter>
+#include <QImage>
 #include <QRectF>
 #include <QString>
 #include <QList>
+#include <QMap>
 
 #include <abstractitembase.h>
 
 class Artboard;
+class DisplayList;
+class SkCanvas;
 
 class ArtboardLabel : public QGraphicsSimpleTextItem
 {
@@ -100,6 +104,9 @@ public:
 
     void setName(QString text) override;
 
+    bool isSnapshotActive() const;
+    void invalidateSnapshot();
+
     // operator
     bool operator==( const Artboard & other ) const;
     inline bool operator!=(const Artboard &itemBase) const;
@@ -119,9 +126,31 @@ private:
     ArtboardLabel * m_label;
     ArtboardCanvas * m_artboard;
 
+    // Rasterized content of the artboard at one zoom bucket
+    struct Snapshot {
+        quint64 revision = 0;
+        bool pending = false;
+        QImage image;
+    };
+
+    QMap<qreal, Snapshot> m_snapshots;
+    QList<qreal> m_snapshotOrder;
+    quint64 m_revision;
+    bool m_snapshotActive;
+    bool m_recordingSnapshot;
+
     void fromObject(AbstractItemBase *obj);
+    void paintSkia(SkCanvas *canvas);
+    bool paintSnapshot(QPainter *painter);
+    void requestSnapshot(qreal scale);
+    bool isEdited() const;
+
+    static qreal snapshotScale(qreal lod);
+    static QImage rasterize(const DisplayList &displayList, const QSize &size);
 
 protected:
+    void writeContent(QDataStream &stream) const override;
+    void childChanged() override;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
     void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
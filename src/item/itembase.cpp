@@ -21,17 +21,22 @@
 **************************************************************************************/
 
 #include <itembase.h>
+#include <artboard.h>
 #include <QDebug>
 #include <pathprocessor.h>
+#include <offsetprocessor.h>
+#include <blurprocessor.h>
+#include <skiarenderer.h>
+#include <profiler.h>
+#include <qt2skia.h>
+#include <skia2qt.h>
+#include <skia_includes.h>
+#include <QFileInfo>
 #include <QGraphicsEffect>
 #include <QGraphicsBlurEffect>
 #include <QGraphicsSceneMouseEvent>
 #include <QStyleOptionGraphicsItem>
-
-QT_BEGIN_NAMESPACE
-// https://code.woboq.org/qt5/qtbase/src/widgets/effects/qpixmapfilter.cpp.html
-extern Q_WIDGETS_EXPORT void qt_blurImage( QPainter *p, QImage &blurImage, qreal radius, bool quality, bool alphaOnly, int transposed = 0 );
-QT_END_NAMESPACE
+#include <QtMath>
 
 ItemBase::ItemBase(const QRectF rect, QGraphicsItem *parent) : AbstractItemBase(rect, parent)
 {
@@ -44,6 +49,8 @@ ItemBase::ItemBase(const QRectF rect, QGraphicsItem *parent) : AbstractItemBase(
     m_hasShadows = false;
     m_hasStrokes = false;
     m_hasInnerShadows = false;
+    m_lodTier = LodPolicy::Full;
+    m_paintedByTiles = false;
 
     this->setFlag(QGraphicsItem::ItemIsSelectable, true);
     this->setFlag(QGraphicsItem::ItemClipsChildrenToShape, true);
@@ -83,6 +90,24 @@ bool ItemBase::operator==(const ItemBase &other) const
             AbstractItemBase::operator==(other);
 }
 
+void ItemBase::writeContent(QDataStream &stream) const
+{
+    AbstractItemBase::writeContent(stream);
+
+    stream << m_fillsList <<
+              m_strokeList <<
+              m_shadowList <<
+              m_innerShadowList;
+
+    // image fills change with the file behind the path
+    foreach(Fills fills, m_fillsList){
+        if(fills.fillType() == FillType::Image){
+            const QFileInfo info(fills.imagePath());
+            stream << info.size() << info.lastModified();
+        }
+    }
+}
+
 
 /***************************************************
  *
@@ -116,8 +141,52 @@ qreal ItemBase::lod()
 }
 
 
+/**
+ * @brief Returns level of details snapped to quarter octave steps. Shadow rasters are cached per step, so small zoom changes
+ * don't trigger a new blur. Values are rounded up to never render below the requested resolution.
+ * @param lod
+ * @return
+ */
+qreal ItemBase::cacheLod(qreal lod)
+{
+    if(lod <= 0) return 1.0;
+    return qPow(2.0, qCeil(std::log2(lod) * 4.0) / 4.0);
+}
+
+
+/**
+ * @brief Returns level of details used to rasterize a shadow. Large blur radii are rendered at reduced resolution and
+ * upscaled with bilinear filtering, so the blur never exceeds a fixed radius in device pixels. The limit depends on renderQuality().
+ * @param radius blur radius in item coordinates
+ * @return
+ */
+qreal ItemBase::shadowLod(qreal radius)
+{
+    qreal maxRadius;
+
+    switch(renderQuality()){
+    case RenderQuality::Quality:
+        maxRadius = 32;
+        break;
+    default:
+    case RenderQuality::Balanced:
+        maxRadius = 16;
+        break;
+    case RenderQuality::Performance:
+        maxRadius = 8;
+        break;
+    }
+
+    qreal _lod = lod();
+    if(radius > 0) _lod = qMin(_lod, maxRadius / radius);
+
+    return cacheLod(_lod);
+}
+
+
 QRectF ItemBase::renderRect() const
 {
+    ensureGeometry();
     return m_renderRect;
 }
 
@@ -126,6 +195,29 @@ void ItemBase::clipsChildrenToShape(bool doClip)
     setFlag(QGraphicsItem::ItemClipsChildrenToShape, doClip);
 }
 
+/**
+ * @brief Returns true if cached shadow raster still matches shadow parameters and level of detail.
+ * @param shadow
+ * @param lod
+ * @param quality
+ * @param useOffset offset is only part of the raster for inner shadows
+ * @return
+ */
+bool ItemBase::ShadowCache::isValid(const Shadow &shadow, qreal lod, bool quality, bool useOffset) const
+{
+    bool valid = !image.isNull() &&
+            this->lod == lod &&
+            this->quality == quality &&
+            radius == shadow.radius() &&
+            spread == shadow.spread() &&
+            color == shadow.color() &&
+            (!useOffset || offset == shadow.offset());
+
+    PROFILE_COUNT(valid ? "shadow cache hit" : "shadow cache miss");
+
+    return valid;
+}
+
 /***************************************************
  *
  * Members
@@ -136,8 +228,7 @@ void ItemBase::addStroke(Stroke stroke)
 {
     m_strokeList.append(stroke);
     m_hasStrokes = hasStrokes();
-    calculateRenderRect();
-    setInvalidateCache(true);
+    invalidate(InvalidateStrokeGeometry | InvalidateShadowGeometry | InvalidateBounds);
 }
 
 void ItemBase::updateStroke(Stroke stroke)
@@ -147,9 +238,11 @@ void ItemBase::updateStroke(Stroke stroke)
         if(m_property.ID() == stroke.ID()){
             m_strokeList.replace(i,stroke);
             m_hasStrokes = hasStrokes();
-            calculateRenderRect();
-            setInvalidateCache(true);
-            update();
+
+            // color or blend mode changes don't touch geometry
+            if(m_property.isOn() == stroke.isOn() && strokeGeometryKey(m_property) == strokeGeometryKey(stroke)){
+                invalidate(InvalidatePaint);
+            }else invalidate(InvalidateStrokeGeometry | InvalidateShadowGeometry | InvalidateBounds);
             return;
         }
     }
@@ -159,9 +252,7 @@ void ItemBase::removeStroke(Stroke stroke)
 {
     m_strokeList.removeOne(stroke);
     m_hasStrokes = hasStrokes();
-    calculateRenderRect();
-    setInvalidateCache(true);
-    update();
+    invalidate(InvalidateStrokeGeometry | InvalidateShadowGeometry | InvalidateBounds);
 }
 
 Stroke ItemBase::stroke(int id) const
@@ -179,7 +270,7 @@ QList<Stroke> ItemBase::strokeList() const
 bool ItemBase::hasStrokes() const
 {
     if(m_strokeList.count() <= 0) return false;
-    foreach(Stroke m_item, m_strokeList){
+    foreach(const Stroke &m_item, m_strokeList){
         if(m_item.isOn()){
             return true;
         }
@@ -191,8 +282,7 @@ void ItemBase::addFills(Fills fills)
 {
     m_fillsList.append(fills);
     m_hasFills = hasFills();
-    calculateRenderRect();
-    setInvalidateCache(true);
+    invalidate(InvalidatePaint);
 }
 
 void ItemBase::updateFills(Fills fills)
@@ -202,9 +292,7 @@ void ItemBase::updateFills(Fills fills)
         if(m_property.ID() == fills.ID()){
             m_fillsList.replace(i,fills);
             m_hasFills = hasFills();
-            calculateRenderRect();
-            setInvalidateCache(true);
-            update();
+            invalidate(InvalidatePaint);
             return;
         }
     }
@@ -214,9 +302,7 @@ void ItemBase::removeFills(Fills fills)
 {
     m_fillsList.removeOne(fills);
     m_hasFills = hasFills();
-    calculateRenderRect();
-    setInvalidateCache(true);
-    update();
+    invalidate(InvalidatePaint);
 }
 
 Fills ItemBase::fills(int id) const
@@ -234,7 +320,7 @@ bool ItemBase::hasFills() const
 {
     if(m_fillsList.count() <= 0) return false;
 
-    foreach(Fills m_item, m_fillsList){
+    foreach(const Fills &m_item, m_fillsList){
         if(m_item.isOn()){
             return true;
         }
@@ -246,8 +332,7 @@ void ItemBase::addShadow(Shadow shadow)
 {
     m_shadowList.append(shadow);
     m_hasShadows = hasShadows();
-    calculateRenderRect();
-    setInvalidateCache(true);
+    invalidate(InvalidateShadowGeometry | InvalidateBounds);
 }
 
 void ItemBase::updateShadow(Shadow shadow)
@@ -257,9 +342,13 @@ void ItemBase::updateShadow(Shadow shadow)
         if(m_property.ID() == shadow.ID()){
             m_shadowList.replace(i,shadow);
             m_hasShadows = hasShadows();
-            calculateRenderRect();
-            setInvalidateCache(true);
-            update();
+
+            if(m_property.isOn() == shadow.isOn() &&
+                    m_property.radius() == shadow.radius() &&
+                    m_property.spread() == shadow.spread() &&
+                    m_property.offset() == shadow.offset()){
+                invalidate(InvalidatePaint);
+            }else invalidate(InvalidateShadowGeometry | InvalidateBounds);
             return;
         }
     }
@@ -269,9 +358,7 @@ void ItemBase::removeShadow(Shadow shadow)
 {
     m_shadowList.removeOne(shadow);
     m_hasShadows = hasShadows();
-    calculateRenderRect();
-    setInvalidateCache(true);
-    update();
+    invalidate(InvalidateShadowGeometry | InvalidateBounds);
 }
 
 Shadow ItemBase::shadow(int id) const
@@ -289,7 +376,7 @@ bool ItemBase::hasShadows() const
 {
     if(m_shadowList.count() <= 0) return false;
 
-    foreach(Shadow m_item, m_shadowList){
+    foreach(const Shadow &m_item, m_shadowList){
         if(m_item.isOn()){
             return true;
         }
@@ -301,8 +388,7 @@ void ItemBase::addInnerShadow(Shadow shadow)
 {
     m_innerShadowList.append(shadow);
     m_hasInnerShadows = hasInnerShadows();
-    calculateRenderRect();
-    setInvalidateCache(true);
+    invalidate(InvalidateShadowGeometry);
 }
 
 void ItemBase::updateInnerShadow(Shadow shadow)
@@ -312,9 +398,13 @@ void ItemBase::updateInnerShadow(Shadow shadow)
         if(m_property.ID() == shadow.ID()){
             m_innerShadowList.replace(i,shadow);
             m_hasInnerShadows = hasInnerShadows();
-            calculateRenderRect();
-            setInvalidateCache(true);
-            update();
+
+            // offset is applied while rasterizing
+            if(m_property.isOn() == shadow.isOn() &&
+                    m_property.radius() == shadow.radius() &&
+                    m_property.spread() == shadow.spread()){
+                invalidate(InvalidatePaint);
+            }else invalidate(InvalidateShadowGeometry);
             return;
         }
     }
@@ -324,9 +414,7 @@ void ItemBase::removeInnerShadow(Shadow shadow)
 {
     m_innerShadowList.removeOne(shadow);
     m_hasInnerShadows = hasInnerShadows();
-    calculateRenderRect();
-    setInvalidateCache(true);
-    update();
+    invalidate(InvalidateShadowGeometry);
 }
 
 Shadow ItemBase::innerShadow(int id) const
@@ -344,7 +432,7 @@ bool ItemBase::hasInnerShadows() const
 {
     if(m_innerShadowList.count() <= 0) return false;
 
-    foreach(Shadow m_item, m_innerShadowList){
+    foreach(const Shadow &m_item, m_innerShadowList){
         if(m_item.isOn()){
             return true;
         }
@@ -384,8 +472,10 @@ void ItemBase::addItem(AbstractItemBase *item)
     item->setParentItem(this);
 }
 
-QRectF ItemBase::drawShadow(Shadow shadow, QPainter *painter)
+QRectF ItemBase::drawShadow(const Shadow &shadow, QPainter *painter)
 {
+    PROFILE_SCOPE("drawShadow", "item");
+
     if(!shadow.isOn()) return QRectF();
 
     PathProcessor pHandler;
@@ -423,27 +513,43 @@ QRectF ItemBase::drawShadow(Shadow shadow, QPainter *painter)
         painter->setClipPath(clip, Qt::ClipOperation::IntersectClip);
     }
 
-    qreal _lod = lod();
-
     if(m_radiusShadow > 0){
 
-        qreal m_width = (mask.boundingRect().width() + buffer * 2 + m_radiusShadow * 2) * _lod;
-        qreal m_height = (mask.boundingRect().height() + buffer * 2 + m_radiusShadow * 2) * _lod;
+        // rounded rects use a size independent nine-slice template
+        if(!drawShadowSlices(shadow, painter)){
+
+            qreal _lod = shadowLod(m_radiusShadow);
+            ShadowCache cache = m_shadowCacheList.value(shadow.ID());
 
-        mask.translate(mask.boundingRect().left() * -1 + buffer + m_radiusShadow,
-                       mask.boundingRect().top() * -1 +buffer + m_radiusShadow);
+            if(!cache.isValid(shadow, _lod, m_doRender, false)){
 
-        // Blur shadow
-        QImage tmp = blurShadow(mask,
-                                QSize(qRound(m_width), qRound(m_height)),
-                                m_radiusShadow,
-                                _lod,
-                                QPainter::CompositionMode_SourceIn,
-                                m_color);
+                qreal m_width = (mask.boundingRect().width() + buffer * 2 + m_radiusShadow * 2) * _lod;
+                qreal m_height = (mask.boundingRect().height() + buffer * 2 + m_radiusShadow * 2) * _lod;
 
+                mask.translate(mask.boundingRect().left() * -1 + buffer + m_radiusShadow,
+                               mask.boundingRect().top() * -1 +buffer + m_radiusShadow);
 
-        // draw shadow
-        painter->drawImage(target, tmp, QRectF(tmp.rect()));
+                // Blur shadow
+                cache.image = blurShadow(mask,
+                                         QSize(qRound(m_width), qRound(m_height)),
+                                         m_radiusShadow,
+                                         _lod,
+                                         QPainter::CompositionMode_SourceIn,
+                                         m_color);
+                cache.radius = m_radiusShadow;
+                cache.spread = shadow.spread();
+                cache.offset = shadow.offset();
+                cache.color = m_color;
+                cache.lod = _lod;
+                cache.quality = m_doRender;
+
+                m_shadowCacheList.insert(shadow.ID(), cache);
+            }
+
+            // draw shadow, downsampled blurs need bilinear upscaling
+            if(_lod < lod()) painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+            painter->drawImage(target, cache.image, QRectF(cache.image.rect()));
+        }
 
     }else{
         mask.translate(m_offsetX,
@@ -457,8 +563,118 @@ QRectF ItemBase::drawShadow(Shadow shadow, QPainter *painter)
 
 }
 
-QRectF ItemBase::drawInnerShadow(Shadow shadow, QPainter *painter)
+/**
+ * @brief Draws a drop shadow of a rounded rect by stretching a blurred template. The template only depends on
+ * corner radius, blur radius and level of detail, so resizing the item doesn't trigger a new blur.
+ * Returns false if the shape doesn't qualify and the regular shadow path has to be used.
+ * @param shadow
+ * @param painter
+ * @return
+ */
+bool ItemBase::drawShadowSlices(const Shadow &shadow, QPainter *painter)
+{
+    QRectF rect;
+    qreal corner = 0;
+
+    if(!isRoundedRect(rect, corner)) return false;
+
+    // strokes outside of the shape change the shadow outline
+    if(m_hasStrokes){
+        foreach(const Stroke &stroke, m_strokeList){
+            if(stroke.isOn() && stroke.strokePosition() != Stroke::Inner) return false;
+        }
+    }
+
+    qreal radius = shadow.radius();
+    qreal spread = shadow.spread();
+
+    rect.adjust(-spread, -spread, spread, spread);
+    if(corner > 0) corner = qMax(0.0, corner + spread);
+
+    qreal _lod = shadowLod(radius);
+
+    // template layout in device pixels: blur padding | corner + blur support | 1px stretch area | ...
+    int padding = qFloor(radius * _lod);
+    int inset = qCeil(corner * _lod) + qCeil(radius * 2 * _lod);
+    int margin = padding + inset + 1;
+    int size = margin * 2 + 1;
+
+    // item is too small to contain the straight edge section
+    if(rect.width() * _lod < (inset + 1) * 2 || rect.height() * _lod < (inset + 1) * 2) return false;
+
+    ShadowCache cache = m_shadowSliceCacheList.value(shadow.ID());
+
+    if(!cache.isValid(shadow, _lod, m_doRender, false) || cache.corner != corner){
+
+        qreal shapeSize = (inset * 2 + 3) / _lod;
+
+        QPainterPath mask;
+        mask.addRoundedRect(QRectF(padding / _lod, padding / _lod, shapeSize, shapeSize), corner, corner);
+
+        cache.image = blurShadow(mask,
+                                 QSize(size, size),
+                                 radius,
+                                 _lod,
+                                 QPainter::CompositionMode_SourceIn,
+                                 shadow.color());
+        cache.radius = radius;
+        cache.spread = spread;
+        cache.offset = shadow.offset();
+        cache.color = shadow.color();
+        cache.lod = _lod;
+        cache.corner = corner;
+        cache.quality = m_doRender;
+
+        m_shadowSliceCacheList.insert(shadow.ID(), cache);
+    }
+
+    QRectF target = rect.adjusted(-padding / _lod, -padding / _lod, padding / _lod, padding / _lod);
+    target.translate(shadow.offset());
+
+    qreal targetMargin = margin / _lod;
+    qreal tx[4] = { target.left(), target.left() + targetMargin, target.right() - targetMargin, target.right() };
+    qreal ty[4] = { target.top(), target.top() + targetMargin, target.bottom() - targetMargin, target.bottom() };
+    int sourceEdges[4] = { 0, margin, margin + 1, size };
+
+    if(_lod < lod()) painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+    for(int y = 0; y < 3; ++y){
+        for(int x = 0; x < 3; ++x){
+            QRectF targetSlice(QPointF(tx[x], ty[y]), QPointF(tx[x+1], ty[y+1]));
+            if(targetSlice.isEmpty()) continue;
+
+            QRectF sourceSlice(QPointF(sourceEdges[x], sourceEdges[y]), QPointF(sourceEdges[x+1], sourceEdges[y+1]));
+            painter->drawImage(targetSlice, cache.image, sourceSlice);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Draws the shadow as flat rect of its bounds, see LodPolicy::Reduced.
+ * @param shadow
+ * @param painter
+ * @return
+ */
+QRectF ItemBase::drawFlatShadow(const Shadow &shadow, QPainter *painter)
+{
+    if(!shadow.isOn()) return QRectF();
+
+    QRectF target = m_shadowPathList.value(shadow.ID()).boundingRect().translated(shadow.offset());
+
+    painter->save();
+    painter->setCompositionMode(shadow.blendMode());
+    painter->fillRect(target, LodPolicy::flatShadowColor(shadow));
+    painter->restore();
+
+    return target;
+}
+
+QRectF ItemBase::drawInnerShadow(const Shadow &shadow, QPainter *painter)
 {
+    PROFILE_SCOPE("drawInnerShadow", "item");
+
     if(!shadow.isOn() || rect().width() == 0 || rect().height() == 0) return QRectF();
 
     PathProcessor pHandler;
@@ -483,26 +699,39 @@ QRectF ItemBase::drawInnerShadow(Shadow shadow, QPainter *painter)
     QPainterPath mask = m_innerShadowPathList.value(shadow.ID());    
     mask.translate(shadow.offset().x(), shadow.offset().y());
 
-    qreal _lod = lod();
-
     if(m_radiusShadow > 0){
 
-        qreal m_width = shape().boundingRect().width() * _lod;
-        qreal m_height = shape().boundingRect().height() * _lod;
-
-        // adjust offset if shape top left point doesn't match rect top left point
-        QPointF shapeOffset = mapToItem(this, shape().boundingRect().topLeft());
-        mask.translate(-shapeOffset.x(), -shapeOffset.y());
-
-        // Blur shadow
-        QImage tmp = blurShadow(mask,
-                                QSize(static_cast<int>(m_width), static_cast<int>(m_height)),
-                                m_radiusShadow,
-                                _lod,
-                                QPainter::CompositionMode_SourceOut,
-                                m_color);
+        qreal _lod = shadowLod(m_radiusShadow);
+        ShadowCache cache = m_innerShadowCacheList.value(shadow.ID());
+
+        if(!cache.isValid(shadow, _lod, m_doRender, true)){
+
+            qreal m_width = shape().boundingRect().width() * _lod;
+            qreal m_height = shape().boundingRect().height() * _lod;
+
+            // adjust offset if shape top left point doesn't match rect top left point
+            QPointF shapeOffset = mapToItem(this, shape().boundingRect().topLeft());
+            mask.translate(-shapeOffset.x(), -shapeOffset.y());
+
+            // Blur shadow
+            cache.image = blurShadow(mask,
+                                     QSize(static_cast<int>(m_width), static_cast<int>(m_height)),
+                                     m_radiusShadow,
+                                     _lod,
+                                     QPainter::CompositionMode_SourceOut,
+                                     m_color);
+            cache.radius = m_radiusShadow;
+            cache.spread = shadow.spread();
+            cache.offset = shadow.offset();
+            cache.color = m_color;
+            cache.lod = _lod;
+            cache.quality = m_doRender;
+
+            m_innerShadowCacheList.insert(shadow.ID(), cache);
+        }
 
-        painter->drawImage(target, tmp, QRectF(tmp.rect()));
+        if(_lod < lod()) painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+        painter->drawImage(target, cache.image, QRectF(cache.image.rect()));
 
     }else{
         painter->setBrush(m_color);
@@ -515,8 +744,10 @@ QRectF ItemBase::drawInnerShadow(Shadow shadow, QPainter *painter)
 
 }
 
-QRectF ItemBase::drawFills(Fills fills, QPainter *painter)
+QRectF ItemBase::drawFills(const Fills &fills, QPainter *painter)
 {
+    PROFILE_SCOPE("drawFills", "item");
+
     if(!fills.isOn() || rect().width() == 0 || rect().height() == 0) return QRectF();
 
     painter->save();
@@ -572,28 +803,7 @@ QRectF ItemBase::drawFills(Fills fills, QPainter *painter)
         if(!texture.isNull())
         {
 
-            QRect imgRect;
-            qreal xratio = texture.width() / shapeRect.width();
-            qreal yratio = texture.height() / shapeRect.height();
-            qreal xOffset = 0;
-            qreal yOffset = 0;
-
-            // Respect the aspect ratio mode.
-            switch (fills.fillMode()) {
-            case Fills::Fill:
-                xratio = yratio = qMin(xratio, yratio);
-                xOffset = (texture.width() - shapeRect.width() * xratio) / 2;
-                yOffset = (texture.height() - shapeRect.height() * yratio) / 2;
-
-                break;
-            case Fills::Fit:
-                xratio = yratio = qMax(xratio, yratio);
-
-                break;
-            case Fills::Stretch:
-                // nothing to do
-                break;
-            case Fills::Tile:
+            if(fills.fillMode() == Fills::Tile){
                 painter->setClipPath(shape(), Qt::ClipOperation::IntersectClip);
                 painter->drawTiledPixmap(shapeRect.toRect(), texture);
                 painter->restore();
@@ -601,10 +811,7 @@ QRectF ItemBase::drawFills(Fills fills, QPainter *painter)
                 return shapeRect;
             }
 
-            imgRect = QRect(static_cast<int>(xOffset),
-                            static_cast<int>(yOffset),
-                            static_cast<int>(shapeRect.width() * xratio),
-                            static_cast<int>(shapeRect.height() * yratio ));
+            QRect imgRect = imageSourceRect(fills, texture.size(), shapeRect);
 
             painter->setOpacity(fills.opacity());
             painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
@@ -622,8 +829,9 @@ QRectF ItemBase::drawFills(Fills fills, QPainter *painter)
     return shapeRect;
 }
 
-QRectF ItemBase::drawStrokes(Stroke stroke, QPainter *painter)
+QRectF ItemBase::drawStrokes(const Stroke &stroke, QPainter *painter)
 {
+    PROFILE_SCOPE("drawStrokes", "item");
 
     if(!stroke.isOn() || stroke.widthF() <= 0) return QRectF();
 
@@ -639,26 +847,27 @@ QRectF ItemBase::drawStrokes(Stroke stroke, QPainter *painter)
     qreal offset = width/2;
 
     QPainterPath pathStroke = shape();
+    QPen pen = stroke.pen();
 
     switch(stroke.strokePosition()){
     case Stroke::Inner:
         offset = 0;
-        stroke.setWidthF(width * 2);
-        painter->setClipPath(shape(), Qt::ClipOperation::IntersectClip);
+        pen.setWidthF(width * 2);
+        painter->setClipPath(pathStroke, Qt::ClipOperation::IntersectClip);
         break;
     case Stroke::Outer:{
         offset = width;
-        stroke.setWidthF(width * 2);
+        pen.setWidthF(width * 2);
         QPainterPath tmpMask;
         tmpMask.addRect(boundingBox.adjusted(-offset,-offset,offset,offset));
-        painter->setClipPath(tmpMask.subtracted(shape()), Qt::ClipOperation::IntersectClip);
+        painter->setClipPath(tmpMask.subtracted(pathStroke), Qt::ClipOperation::IntersectClip);
         break;
     }
     case Stroke::Center:
         break;
     }
 
-    painter->setPen(stroke.pen());
+    painter->setPen(pen);
     painter->drawPath(pathStroke);
     painter->restore();
 
@@ -683,93 +892,531 @@ QRectF ItemBase::drawBlur(qreal radius, QPainter* painter)
     return boundingBox;
 }
 
+/**
+ * @brief Returns the part of an image fill texture which is mapped onto the shape bounds.
+ * @param fills
+ * @param textureSize
+ * @param shapeRect
+ * @return
+ */
+QRect ItemBase::imageSourceRect(const Fills &fills, const QSize &textureSize, const QRectF &shapeRect)
+{
+    qreal xratio = textureSize.width() / shapeRect.width();
+    qreal yratio = textureSize.height() / shapeRect.height();
+    qreal xOffset = 0;
+    qreal yOffset = 0;
+
+    // Respect the aspect ratio mode.
+    switch (fills.fillMode()) {
+    case Fills::Fill:
+        xratio = yratio = qMin(xratio, yratio);
+        xOffset = (textureSize.width() - shapeRect.width() * xratio) / 2;
+        yOffset = (textureSize.height() - shapeRect.height() * yratio) / 2;
+
+        break;
+    case Fills::Fit:
+        xratio = yratio = qMax(xratio, yratio);
+
+        break;
+    case Fills::Stretch:
+    case Fills::Tile:
+        // nothing to do
+        break;
+    }
+
+    return QRect(static_cast<int>(xOffset),
+                 static_cast<int>(yOffset),
+                 static_cast<int>(shapeRect.width() * xratio),
+                 static_cast<int>(shapeRect.height() * yratio ));
+}
+
+/***************************************************
+ *
+ * Skia backend
+ *
+ ***************************************************/
+
+/**
+ * @brief Draws all layers into a Skia canvas. Skia rasterizes blurs, gradients and strokes itself,
+ * so none of the QPainter raster caches are used.
+ * @param canvas
+ */
+void ItemBase::paintSkia(SkCanvas *canvas)
+{
+    const SkPath path = skia::skPath(shape());
+
+    if(m_hasShadows){
+        foreach(const Shadow &shadow, m_shadowList){
+            if(m_lodTier >= LodPolicy::Reduced) drawFlatShadow(shadow, canvas);
+            else drawShadow(shadow, path, canvas);
+        }
+    }
+
+    if(m_hasFills){
+        foreach(const Fills &fills, m_fillsList)
+            drawFills(LodPolicy::simplified(fills, m_lodTier), path, canvas);
+    }
+
+    if(m_hasInnerShadows && m_lodTier < LodPolicy::Reduced){
+        foreach(const Shadow &shadow, m_innerShadowList)
+            drawInnerShadow(shadow, path, canvas);
+    }
+
+    if(m_hasStrokes){
+        foreach(const Stroke &stroke, m_strokeList){
+            if(m_lodTier >= LodPolicy::Minimal && !LodPolicy::isVisible(stroke.widthF(), m_lod, renderQuality())) continue;
+            drawStrokes(stroke, path, canvas);
+        }
+    }
+}
+
+void ItemBase::drawShadow(const Shadow &shadow, const SkPath &shape, SkCanvas *canvas)
+{
+    PROFILE_SCOPE("drawShadow", "item");
+
+    if(!shadow.isOn()) return;
+
+    SkPath mask = skia::skPath(m_shadowPathList.value(shadow.ID()));
+    mask.setFillType(SkPathFillType::kWinding);
+    mask.offset(SkFloatToScalar(shadow.offset().x()), SkFloatToScalar(shadow.offset().y()));
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(skia::skColor(shadow.color()));
+    paint.setBlendMode(SkiaRenderer::blendMode(shadow.blendMode()));
+
+    // same sigma as BlurProcessor
+    if(shadow.radius() > 0){
+        paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, SkFloatToScalar(shadow.radius() / 2)));
+    }
+
+    canvas->save();
+    if(m_hasFills) canvas->clipPath(shape, SkClipOp::kDifference, true);
+    canvas->drawPath(mask, paint);
+    canvas->restore();
+}
+
+/**
+ * @brief Draws the shadow as flat rect of its bounds, see LodPolicy::Reduced.
+ * @param shadow
+ * @param canvas
+ */
+void ItemBase::drawFlatShadow(const Shadow &shadow, SkCanvas *canvas)
+{
+    if(!shadow.isOn()) return;
+
+    QRectF target = m_shadowPathList.value(shadow.ID()).boundingRect().translated(shadow.offset());
+
+    SkPaint paint;
+    paint.setColor(skia::skColor(LodPolicy::flatShadowColor(shadow)));
+    paint.setBlendMode(SkiaRenderer::blendMode(shadow.blendMode()));
+
+    canvas->drawRect(skia::skRect(target), paint);
+}
+
+void ItemBase::drawInnerShadow(const Shadow &shadow, const SkPath &shape, SkCanvas *canvas)
+{
+    PROFILE_SCOPE("drawInnerShadow", "item");
+
+    if(!shadow.isOn() || rect().width() == 0 || rect().height() == 0) return;
+
+    SkPath mask = skia::skPath(m_innerShadowPathList.value(shadow.ID()));
+    mask.offset(SkFloatToScalar(shadow.offset().x()), SkFloatToScalar(shadow.offset().y()));
+
+    // everything around the inset shape, large enough to keep the blur support inside
+    qreal margin = shadow.radius() * 2 + qAbs(shadow.offset().x()) + qAbs(shadow.offset().y()) + 1;
+    SkPath area;
+    area.addRect(shape.getBounds().makeOutset(SkFloatToScalar(margin), SkFloatToScalar(margin)));
+
+    SkPath outside;
+    if(!Op(area, mask, kDifference_SkPathOp, &outside)) return;
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(skia::skColor(shadow.color()));
+    paint.setBlendMode(SkiaRenderer::blendMode(shadow.blendMode()));
+
+    if(shadow.radius() > 0){
+        paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, SkFloatToScalar(shadow.radius() / 2)));
+    }
+
+    canvas->save();
+    canvas->clipPath(shape, SkClipOp::kIntersect, true);
+    canvas->drawPath(outside, paint);
+    canvas->restore();
+}
+
+void ItemBase::drawFills(const Fills &fills, const SkPath &shape, SkCanvas *canvas)
+{
+    PROFILE_SCOPE("drawFills", "item");
+
+    if(!fills.isOn() || rect().width() == 0 || rect().height() == 0) return;
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setBlendMode(SkiaRenderer::blendMode(fills.blendMode()));
+
+    switch(fills.fillType()){
+    case FillType::Color:
+        paint.setColor(skia::skColor(fills.color()));
+        canvas->drawPath(shape, paint);
+        break;
+    case FillType::Pattern:
+        break;
+    case FillType::RadialGradient:{
+        QRadialGradient rg(fills.gradient().radial(rect()));
+        rg.setCenter(rect().center());
+        paint.setShader(SkiaRenderer::shader(rg));
+        paint.setAlphaf(SkFloatToScalar(fills.opacity()));
+        canvas->drawPath(shape, paint);
+        break;
+    }
+    case FillType::ConicalGradient:{
+        QConicalGradient cg(fills.gradient().conical(rect()));
+        cg.setCenter(rect().center());
+        paint.setShader(SkiaRenderer::shader(cg));
+        paint.setAlphaf(SkFloatToScalar(fills.opacity()));
+        canvas->drawPath(shape, paint);
+        break;
+    }
+    case FillType::LinearGradient:
+        paint.setShader(SkiaRenderer::shader(fills.gradient().linear( QLineF(QPointF(), QPointF(0,rect().bottom())) )));
+        paint.setAlphaf(SkFloatToScalar(fills.opacity()));
+        canvas->drawPath(shape, paint);
+        break;
+    case FillType::Image:{
+        QPixmap texture = fills.pixmap();
+        if(texture.isNull()) break;
+
+        sk_sp<SkImage> image = SkiaRenderer::image(texture.toImage());
+        if(!image) break;
+
+        QRectF shapeRect = this->shape().boundingRect();
+        paint.setAlphaf(SkFloatToScalar(fills.opacity()));
+
+        canvas->save();
+        canvas->clipPath(shape, SkClipOp::kIntersect, true);
+
+        if(fills.fillMode() == Fills::Tile){
+            SkMatrix matrix = SkMatrix::MakeTrans(SkFloatToScalar(shapeRect.x()), SkFloatToScalar(shapeRect.y()));
+            paint.setShader(image->makeShader(SkTileMode::kRepeat, SkTileMode::kRepeat, &matrix));
+            canvas->drawRect(skia::skRect(shapeRect), paint);
+        }else{
+            QRect imgRect = imageSourceRect(fills, texture.size(), shapeRect);
+            canvas->drawImageRect(image, skia::skRect(imgRect), skia::skRect(shapeRect), &paint);
+        }
+
+        canvas->restore();
+        break;
+    }
+    }
+}
+
+void ItemBase::drawStrokes(const Stroke &stroke, const SkPath &shape, SkCanvas *canvas)
+{
+    PROFILE_SCOPE("drawStrokes", "item");
+
+    if(!stroke.isOn() || stroke.widthF() <= 0) return;
+
+    canvas->save();
+
+    QPen pen = stroke.pen();
+
+    // inner and outer strokes are centered strokes of double width clipped by the shape
+    switch(stroke.strokePosition()){
+    case Stroke::Inner:
+        pen.setWidthF(stroke.widthF() * 2);
+        canvas->clipPath(shape, SkClipOp::kIntersect, true);
+        break;
+    case Stroke::Outer:
+        pen.setWidthF(stroke.widthF() * 2);
+        canvas->clipPath(shape, SkClipOp::kDifference, true);
+        break;
+    case Stroke::Center:
+        break;
+    }
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setBlendMode(SkiaRenderer::blendMode(stroke.blendMode()));
+
+    if(SkiaRenderer::setPen(paint, pen)) canvas->drawPath(shape, paint);
+
+    canvas->restore();
+}
+
 QPainterPath ItemBase::strokeShape() const
 {
     QPainterPath strokeShape;
 
     if(m_hasStrokes){
-        PathProcessor pHandler;
-        QPainterPath pathMask = shape();
-
-        foreach(Stroke stroke, strokeList()) {
-            if(stroke.isOn()){
-                qreal width = stroke.widthF();
-                switch(stroke.strokePosition()){
-                case Stroke::Inner:
-                    pathMask = pHandler.combine(scaleStroke(shape(), width*2, stroke.pen()), shape(), PathProcessor::Booleans::Intersect);
-                    break;
-                case Stroke::Outer:{
-                    pathMask = pHandler.combine(scaleStroke(shape(), width*2, stroke.pen()), shape(), PathProcessor::Booleans::Subtract);
-                    break;
-                }
-                case Stroke::Center:
-                    pathMask = scaleStroke(shape(), width, stroke.pen());
-                    break;
-                }
+        QString key = strokeShapeKey();
+        if(isGeometryCached(m_strokeShapeCache, key)) return m_strokeShapeCache.path;
 
-                strokeShape = pHandler.combine(strokeShape, pathMask, PathProcessor::Booleans::Unite);
-            }
+        // unite all outlines in one pass and convert the result only once
+        QList<SkPath> outlines;
+
+        foreach(const Stroke &stroke, m_strokeList) {
+            if(stroke.isOn()) outlines.append(strokeOutline(stroke));
         }
+
+        const SkPath united = (outlines.size() == 1) ? outlines.first() : PathProcessor::combineMany(outlines);
+
+        strokeShape = skia::qtPath(united);
+        storeGeometry(m_strokeShapeCache, key, strokeShape, united);
     }
 
     return strokeShape;
 }
 
 
-// https://code.woboq.org/qt5/qtbase/src/widgets/effects/qpixmapfilter.cpp.html
-// void QPixmapDropShadowFilter::draw(QPainter *p, const QPointF &pos, const QPixmap &px, const QRectF &src) const
+/**
+ * @brief Returns the filled outline of a single stroke. Outlines are cached per stroke until shape or stroke geometry changes.
+ * The outline stays a SkPath since it is only used as operand of further path operations.
+ * @param stroke
+ * @return
+ */
+SkPath ItemBase::strokeOutline(const Stroke &stroke) const
+{
+    QString key = strokeGeometryKey(stroke);
+    GeometryCache &cache = m_strokeGeometryList[stroke.ID()];
+
+    if(isGeometryCached(cache, key)) return cache.skPath;
+
+    const SkPath source = skia::skPath(shape());
+    PathProcessor::Pipeline pipeline(source);
+    qreal width = stroke.widthF();
+
+    switch(stroke.strokePosition()){
+    case Stroke::Inner:
+        pipeline.stroke(stroke.pen(), width*2).combine(source, PathProcessor::Booleans::Intersect);
+        break;
+    case Stroke::Outer:
+        pipeline.stroke(stroke.pen(), width*2).combine(source, PathProcessor::Booleans::Subtract);
+        break;
+    case Stroke::Center:
+        pipeline.stroke(stroke.pen(), width);
+        break;
+    }
+
+    storeGeometry(cache, key, QPainterPath(), pipeline.path());
+
+    return pipeline.path();
+}
+
+
+/**
+ * @brief Returns key of all stroke properties which affect the union stroke shape.
+ * @return
+ */
+QString ItemBase::strokeShapeKey() const
+{
+    QString key;
+
+    foreach(const Stroke &stroke, m_strokeList) {
+        if(stroke.isOn()) key += stroke.ID() + ":" + strokeGeometryKey(stroke) + ";";
+    }
+
+    return key;
+}
+
+
+/**
+ * @brief Returns key of stroke properties which affect the stroke outline. Colors and blend modes are not part of it.
+ * @param stroke
+ * @return
+ */
+QString ItemBase::strokeGeometryKey(const Stroke &stroke)
+{
+    return QString("%1|%2|%3|%4|%5").arg(QString::number(stroke.widthF(), 'g', 17))
+            .arg(stroke.strokePosition())
+            .arg(stroke.style())
+            .arg(stroke.capStyle())
+            .arg(stroke.joinStyle());
+}
+
+
+bool ItemBase::isGeometryCached(const GeometryCache &cache, const QString &key) const
+{
+    bool hit = cache.revision == shapeRevision() && cache.key == key;
+
+    // hits and misses are reported by the profiler counters
+    PROFILE_COUNT(hit ? "geometry cache hit" : "geometry cache miss");
+
+    return hit;
+}
+
+
+void ItemBase::storeGeometry(GeometryCache &cache, const QString &key, const QPainterPath &path, const SkPath &skPath) const
+{
+    cache.revision = shapeRevision();
+    cache.key = key;
+    cache.path = path;
+    cache.skPath = skPath;
+}
+
+
+/**
+ * @brief Returns true if the item shape is an axis aligned rectangle with uniform corner radius.
+ * Items which can describe their shape this way get nine-slice shadows.
+ * @param rect
+ * @param radius
+ * @return
+ */
+bool ItemBase::isRoundedRect(QRectF &rect, qreal &radius) const
+{
+    Q_UNUSED(rect)
+    Q_UNUSED(radius)
+    return false;
+}
+
+
+/**
+ * @brief Returns true if the item shape is a rect, rounded rect or ellipse.
+ * Shadow spread and inner shadow insets of such items are calculated analytically.
+ * @param rrect
+ * @return
+ */
+bool ItemBase::isPrimitive(SkRRect &rrect) const
+{
+    Q_UNUSED(rrect)
+    return false;
+}
+
 
 QImage ItemBase::blurShadow(QPainterPath shape, QSize size, qreal radius, qreal lod, QPainter::CompositionMode compositionMode, QColor color) const
 {
-    // Draw Shadow Pixmap
-    QImage tmp(size, QImage::Format_ARGB32_Premultiplied);
-    tmp.fill(0);
+    PROFILE_SCOPE("blurShadow", "shadow");
+    PROFILE_COUNT("blurShadow allocations");
+
+    // Draw Shadow mask
+    QImage mask(size, QImage::Format_Alpha8);
+    mask.fill(0);
 
-    QPainter pxPainter(&tmp);
+    QPainter pxPainter(&mask);
     pxPainter.scale(lod,lod);
     pxPainter.setRenderHint(QPainter::Antialiasing, true);
     pxPainter.fillPath(shape, Qt::black);
     pxPainter.end();
 
     // blur the alpha channel
-    QImage blurred(tmp.size(), QImage::Format_ARGB32_Premultiplied);
-    blurred.fill(0);
-    QPainter blurPainter(&blurred);
-
-    qt_blurImage(&blurPainter, tmp, radius * lod, m_doRender, true);
-
-    tmp = blurred;
+    BlurProcessor::blur(mask, radius * lod);
 
     // tint Shadow
-    pxPainter.begin(&tmp);
-    pxPainter.setCompositionMode(compositionMode);
-    pxPainter.fillRect(blurred.rect(), QBrush(color));
-    pxPainter.end();
-
-    return tmp;
+    return BlurProcessor::tint(mask, color, compositionMode == QPainter::CompositionMode_SourceOut);
 }
 
 
 void ItemBase::calculateRenderRect()
 {
-    m_shadowPath = QPainterPath();
+    const Invalidations flags = invalidations();
+
+    // fills and strokes are the source of the drop shadows
+    if(flags & (InvalidateShape | InvalidateStrokeGeometry)){
 
- //   if(m_hasFills){
         m_shadowPath = shape();
- //   }
 
-    if(m_hasStrokes){
-        m_shadowPath.addPath(strokeShape());
+        if(m_hasStrokes){
+            m_shadowPath.addPath(strokeShape());
+        }
+
+        // drop outlines of removed strokes
+        foreach(const QString &id, m_strokeGeometryList.keys()){
+            bool found = false;
+            foreach(const Stroke &stroke, m_strokeList){
+                if(stroke.ID() == id){
+                    found = true;
+                    break;
+                }
+            }
+            if(!found) m_strokeGeometryList.remove(id);
+        }
+    }
+
+    // Calculate inner shadow paths, they only follow the shape
+    if(flags & (InvalidateShape | InvalidateShadowGeometry)){
+        calculateInnerShadowPaths();
+    }
+
+    // Calculate drop shadow paths, a shadow only change keeps the stroke outlines
+    if(flags & (InvalidateShape | InvalidateStrokeGeometry | InvalidateShadowGeometry)){
+        m_shadowRect = calculateShadowPaths();
+    }
+
+    m_renderRect = m_boundingRect = (m_shadowRect.isEmpty()) ? shape().boundingRect() : m_shadowRect;
+
+    validate(InvalidateGeometry);
+
+
+}
+
+
+void ItemBase::calculateGeometry()
+{
+    // while the user resizes the item only the bounds follow the shape,
+    // stroke and shadow geometry is calculated once the resize ends
+    if(isInteractiveResize()){
+        m_renderRect = m_boundingRect = rect().marginsAdded(m_resizeMargins);
+
+        // shadows of the last full calculation are scaled to the current frame,
+        // their cached rasters get stretched to the scaled bounds
+        const QTransform resizeMap = resizeTransform();
+        m_shadowPathList.clear();
+        m_innerShadowPathList.clear();
+        foreach(const QString &id, m_resizeShadowPathList.keys()){
+            m_shadowPathList.insert(id, resizeMap.map(m_resizeShadowPathList.value(id)));
+        }
+        foreach(const QString &id, m_resizeInnerShadowPathList.keys()){
+            m_innerShadowPathList.insert(id, resizeMap.map(m_resizeInnerShadowPathList.value(id)));
+        }
+
+        validate(InvalidateGeometry);
+        return;
     }
 
-    // Calculate inner shadow paths
-    calculateInnerShadowPaths();
+    m_resizeShadowPathList.clear();
+    m_resizeInnerShadowPathList.clear();
 
-    // Calculate drop shadow paths
-    QRectF tmpRect = calculateShadowPaths();
-    m_renderRect = m_boundingRect = (tmpRect.isEmpty()) ? shape().boundingRect() : tmpRect;
+    calculateRenderRect();
+}
 
 
+/**
+ * @brief Keeps the distance of strokes and shadows to the item rect for the bounds used while resizing.
+ */
+void ItemBase::beginInteractiveResize()
+{
+    if(isInteractiveResize()) return;
+
+    ensureGeometry();
+
+    const QRectF frame = rect();
+    m_resizeMargins = QMarginsF(qMax(0.0, frame.left() - m_renderRect.left()),
+                                qMax(0.0, frame.top() - m_renderRect.top()),
+                                qMax(0.0, m_renderRect.right() - frame.right()),
+                                qMax(0.0, m_renderRect.bottom() - frame.bottom()));
+
+    m_resizeFrame = frame;
+    m_resizeShadowPathList = m_shadowPathList;
+    m_resizeInnerShadowPathList = m_innerShadowPathList;
+
+    AbstractItemBase::beginInteractiveResize();
+}
+
+
+/**
+ * @brief Returns the mapping of the item rect at the begin of the interactive resize to the current item rect.
+ * @return
+ */
+QTransform ItemBase::resizeTransform() const
+{
+    const QRectF frame = rect();
+
+    if(m_resizeFrame.width() == 0 || m_resizeFrame.height() == 0) return QTransform();
+
+    return QTransform::fromTranslate(-m_resizeFrame.left(), -m_resizeFrame.top()) *
+            QTransform::fromScale(frame.width() / m_resizeFrame.width(), frame.height() / m_resizeFrame.height()) *
+            QTransform::fromTranslate(frame.left(), frame.top());
 }
 
 
@@ -778,9 +1425,34 @@ QRectF ItemBase::calculateShadowPaths()
     m_shadowPathList.clear();
     QRectF bound = m_shadowPath.boundingRect();
 
-    foreach(Shadow shadow, m_shadowList){
+    QString sourceKey = m_hasStrokes ? strokeShapeKey() : QString();
+    SkRRect primitive;
+    const bool isPrimitiveSource = !m_hasStrokes && isPrimitive(primitive);
+    SkPath source;
+    bool hasSource = false;
+
+    foreach(const Shadow &shadow, m_shadowList){
         if(shadow.isOn()){
-            QPainterPath mask = PathProcessor::scale(m_shadowPath, shadow.spread()*2);
+            QString key = sourceKey + "|" + QString::number(shadow.spread(), 'g', 17);
+            GeometryCache &cache = m_shadowGeometryList[shadow.ID()];
+
+            if(!isGeometryCached(cache, key)){
+                if(isPrimitiveSource){
+                    storeGeometry(cache, key, skia::qtPath(OffsetProcessor::offset(primitive, shadow.spread())));
+                }else{
+                    // build the SkPath source once and share it between all shadows
+                    if(!hasSource){
+                        source = skia::skPath(shape());
+                        if(m_hasStrokes) source.addPath(m_strokeShapeCache.skPath);
+                        hasSource = true;
+                    }
+
+                    storeGeometry(cache, key, skia::qtPath(OffsetProcessor::offset(source, shadow.spread())));
+                }
+                m_shadowCacheList.remove(shadow.ID());
+            }
+
+            QPainterPath mask = cache.path;
             m_shadowPathList.insert(shadow.ID(),mask);
 
             qreal radius = shadow.radius();
@@ -791,54 +1463,173 @@ QRectF ItemBase::calculateShadowPaths()
         }
     }
 
+    // slice templates survive shape changes, only drop the ones of removed shadows
+    foreach(const QString &id, m_shadowSliceCacheList.keys()){
+        if(!m_shadowPathList.contains(id)) m_shadowSliceCacheList.remove(id);
+    }
+
+    foreach(const QString &id, m_shadowGeometryList.keys()){
+        if(!m_shadowPathList.contains(id)) m_shadowGeometryList.remove(id);
+    }
+
     return bound;
 }
 
 void ItemBase::calculateInnerShadowPaths()
 {
     m_innerShadowPathList.clear();
-    PathProcessor pHandler;   
 
-    foreach(Shadow shadow, m_innerShadowList){
+    SkRRect primitive;
+    const bool isPrimitiveSource = isPrimitive(primitive);
+
+    foreach(const Shadow &shadow, m_innerShadowList){
         if(shadow.isOn()){
-            QPainterPath mask = pHandler.scale(shape(), -shadow.radius() - shadow.spread());
-            m_innerShadowPathList.insert(shadow.ID(),mask);
+            qreal amount = -shadow.radius() - shadow.spread();
+            QString key = QString::number(amount, 'g', 17);
+            GeometryCache &cache = m_innerShadowGeometryList[shadow.ID()];
+
+            if(!isGeometryCached(cache, key)){
+                SkPath path = isPrimitiveSource ? OffsetProcessor::offset(primitive, amount / 2)
+                                                : OffsetProcessor::offset(skia::skPath(shape()), amount / 2);
+                storeGeometry(cache, key, skia::qtPath(path));
+                m_innerShadowCacheList.remove(shadow.ID());
+            }
+
+            m_innerShadowPathList.insert(shadow.ID(),cache.path);
         }
     }
+
+    foreach(const QString &id, m_innerShadowGeometryList.keys()){
+        if(!m_innerShadowPathList.contains(id)) m_innerShadowGeometryList.remove(id);
+    }
 }
 
 
 void ItemBase::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {    
-    Q_UNUSED(widget);
+    // the view shows tiled items by tiles, recordings for the tiles pass no widget
+    m_paintedByTiles = isTiled() && widget;
+
+    PROFILE_ITEM_SCOPE("ItemBase::paint", "item", name());
 
     if (rect().width() <= 0 || rect().height() <= 0) return;
 
     m_lod = option->levelOfDetailFromTransform( painter->transform());
+    m_lodTier = m_doRender ? LodPolicy::Full : LodPolicy::tier(m_lod, renderQuality());
+
+    ensureGeometry();
+
+    if(isCulled()) return;
+
+    // drop cached shadow rasters if item was modified since last paint,
+    // while resizing the last rasters are scaled until the resize ends
+    if(invalidateCache() && !isInteractiveResize()){
+        m_shadowCacheList.clear();
+        m_innerShadowCacheList.clear();
+        setInvalidateCache(false);
+        m_invalidations |= InvalidatePaint;
+    }
 
+    // exports and recordings always get QPainter commands
+    if(!m_doRender && SkiaRenderer::isTarget(painter) &&
+            SkiaRenderer::render(painter, renderRect(), [this](SkCanvas *canvas){ paintSkia(canvas); })) return;
+
+    updateDisplayList();
+
+    PROFILE_SCOPE("DisplayList::replay", "item");
+    m_displayListCache.list.replay(painter);
+}
+
+/**
+ * @brief Returns the recorded layers of the item at the level of detail of the last paint.
+ * @return
+ */
+DisplayList ItemBase::displayList()
+{
+    ensureGeometry();
+    updateDisplayList();
+
+    return m_displayListCache.list;
+}
+
+/**
+ * @brief Records all layers into the display list if the item was invalidated or the level of detail bucket changed.
+ */
+void ItemBase::updateDisplayList()
+{
+    const qreal _lod = cacheLod(lod());
+
+    if(!invalidations().testFlag(InvalidatePaint) &&
+            m_displayListCache.lod == _lod &&
+            m_displayListCache.tier == m_lodTier &&
+            m_displayListCache.quality == renderQuality() &&
+            m_displayListCache.render == m_doRender) return;
+
+    PROFILE_SCOPE("DisplayList::record", "item");
+
+    DisplayListRecorder recorder;
+    QPainter painter(&recorder);
+    paintLayers(&painter);
+    painter.end();
+
+    m_displayListCache.list = recorder.displayList();
+    m_displayListCache.lod = _lod;
+    m_displayListCache.tier = m_lodTier;
+    m_displayListCache.quality = renderQuality();
+    m_displayListCache.render = m_doRender;
+
+    validate(InvalidatePaint);
+}
+
+/**
+ * @brief Returns true if the artboard of the item composites a cached snapshot in place of its items.
+ * @return
+ */
+bool ItemBase::isCoveredBySnapshot() const
+{
+    Artboard *artboard = dynamic_cast<Artboard*>(topLevelItem());
+    return artboard && artboard->isSnapshotActive();
+}
+
+/**
+ * @brief Returns true if the last paint call skipped the item. Far zoomed out items are part of the artboard snapshot
+ * or too small to be seen, tiled items are painted by the tiles of the view. Rendering for export never culls.
+ * @return
+ */
+bool ItemBase::isCulled() const
+{
+    return !m_doRender && (m_paintedByTiles || isCoveredBySnapshot() || !LodPolicy::isVisible(renderRect(), m_lod, renderQuality()));
+}
+
+void ItemBase::paintLayers(QPainter *painter)
+{
     // Drop Shadow
     if(m_hasShadows){
-        foreach(Shadow shadow, this->shadowList())
-            drawShadow(shadow, painter);
+        foreach(const Shadow &shadow, m_shadowList){
+            if(m_lodTier >= LodPolicy::Reduced) drawFlatShadow(shadow, painter);
+            else drawShadow(shadow, painter);
+        }
     }
 
     // Draw Fills
     if(m_hasFills){
-        foreach(Fills fills,this->fillsList())
-            drawFills(fills, painter);
+        foreach(const Fills &fills, m_fillsList)
+            drawFills(LodPolicy::simplified(fills, m_lodTier), painter);
     }
 
     // Draw InnerShadows
-    if(m_hasInnerShadows){
-        foreach(Shadow shadow, this->innerShadowList())
+    if(m_hasInnerShadows && m_lodTier < LodPolicy::Reduced){
+        foreach(const Shadow &shadow, m_innerShadowList)
             drawInnerShadow(shadow, painter);
     }
 
     // Draw Strokes
     if(m_hasStrokes){
-        foreach(Stroke stroke, this->strokeList())
+        foreach(const Stroke &stroke, m_strokeList){
+            if(m_lodTier >= LodPolicy::Minimal && !LodPolicy::isVisible(stroke.widthF(), m_lod, renderQuality())) continue;
             drawStrokes(stroke, painter);
         }
+    }
 }
 
 void ItemBase::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
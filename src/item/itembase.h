@@ -29,6 +29,7 @@
 #include <QList>
 #include <QImage>
 #include <QPixmapCache>
+#include <QTransform>
 
 #include <utilities.h>
 #include <stroke.h>
@@ -36,6 +37,10 @@
 #include <gradient.h>
 #include <shadow.h>
 #include <abstractitembase.h>
+#include <displaylist.h>
+#include <lodpolicy.h>
+#include <skia_includes.h>
+
 
 class ItemBase : public AbstractItemBase
 {
@@ -90,18 +95,62 @@ public:
     QPainterPath scaleStroke(const QPainterPath & path, qreal amount , QPen pen = QPen()) const;
 
     void addItem(AbstractItemBase *item) override;
-    void calculateRenderRect();
+    virtual bool isRoundedRect(QRectF &rect, qreal &radius) const;
+    virtual bool isPrimitive(SkRRect &rrect) const;
+    void beginInteractiveResize() override;
+    DisplayList displayList();
 
     // Events
     virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
     void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
 
+protected:
+
+    void calculateGeometry() override;
+    void writeContent(QDataStream &stream) const override;
+    bool isCulled() const;
+
 private:
+
+    // Rendered shadow raster of one shadow property at a quantized level of detail
+    struct ShadowCache {
+        qreal radius = 0;
+        qreal spread = 0;
+        QPointF offset;
+        QColor color;
+        qreal lod = 0;
+        qreal corner = 0;
+        bool quality = false;
+        QImage image;
+
+        bool isValid(const Shadow &shadow, qreal lod, bool quality, bool useOffset) const;
+    };
+
+    // Recorded layers of one level of detail bucket, render tier and quality setting
+    struct DisplayListCache {
+        qreal lod = 0;
+        LodPolicy::Tier tier = LodPolicy::Full;
+        RenderQuality quality = RenderQuality::Balanced;
+        bool render = false;
+        DisplayList list;
+    };
+
+    // Derived outline, valid as long as shape revision and geometry key match
+    struct GeometryCache {
+        quint64 revision = 0;
+        QString key;
+        QPainterPath path;
+        SkPath skPath;
+    };
+
 	// Properties
     Stroke::StrokePosition m_strokePosition;
     QPainterPath m_shadowPath;
     QRectF m_renderRect;
+    QRectF m_shadowRect;
+    QMarginsF m_resizeMargins;
+    QRectF m_resizeFrame;
 
     // Members
     QList<Fills>                m_fillsList;
@@ -110,6 +159,19 @@ private:
     QList<Shadow>               m_innerShadowList;
     QMap<QString,QPainterPath>  m_shadowPathList;
     QMap<QString,QPainterPath>  m_innerShadowPathList;
+    QMap<QString,QPainterPath>  m_resizeShadowPathList;
+    QMap<QString,QPainterPath>  m_resizeInnerShadowPathList;
+    QMap<QString,ShadowCache>   m_shadowCacheList;
+    QMap<QString,ShadowCache>   m_innerShadowCacheList;
+    QMap<QString,ShadowCache>   m_shadowSliceCacheList;
+    mutable QMap<QString,GeometryCache> m_strokeGeometryList;
+    mutable GeometryCache       m_strokeShapeCache;
+    QMap<QString,GeometryCache> m_shadowGeometryList;
+    QMap<QString,GeometryCache> m_innerShadowGeometryList;
+
+    DisplayListCache            m_displayListCache;
+    LodPolicy::Tier             m_lodTier;
+    bool                        m_paintedByTiles;
 
     bool m_hasFills;
     bool m_hasStrokes;
@@ -118,19 +180,42 @@ private:
 
 
     qreal lod();
+    static qreal cacheLod(qreal lod);
+    qreal shadowLod(qreal radius);
     QPainterPath strokeShape() const;
+    SkPath strokeOutline(const Stroke &stroke) const;
+    QString strokeShapeKey() const;
+    static QString strokeGeometryKey(const Stroke &stroke);
+    bool isGeometryCached(const GeometryCache &cache, const QString &key) const;
+    void storeGeometry(GeometryCache &cache, const QString &key, const QPainterPath &path, const SkPath &skPath = SkPath()) const;
 
     // functions    
+    void updateDisplayList();
+    bool isCoveredBySnapshot() const;
+    void paintLayers(QPainter *painter);
     QImage blurShadow(QPainterPath shape, QSize size, qreal radius, qreal lod, QPainter::CompositionMode compositionMode, QColor tintColor = Qt::black) const;
 
-    QRectF drawShadow(Shadow shadow, QPainter *painter);
-    QRectF drawInnerShadow(Shadow shadow, QPainter *painter);
-    QRectF drawFills(Fills fills, QPainter *painter);
-    QRectF drawStrokes(Stroke stroke, QPainter *painter);
+    QRectF drawShadow(const Shadow &shadow, QPainter *painter);
+    QRectF drawFlatShadow(const Shadow &shadow, QPainter *painter);
+    bool drawShadowSlices(const Shadow &shadow, QPainter *painter);
+    QRectF drawInnerShadow(const Shadow &shadow, QPainter *painter);
+    QRectF drawFills(const Fills &fills, QPainter *painter);
+    QRectF drawStrokes(const Stroke &stroke, QPainter *painter);
     QRectF drawBlur(qreal radius, QPainter *painter);
+    static QRect imageSourceRect(const Fills &fills, const QSize &textureSize, const QRectF &shapeRect);
 
+    // Skia backend
+    void paintSkia(SkCanvas *canvas);
+    void drawShadow(const Shadow &shadow, const SkPath &shape, SkCanvas *canvas);
+    void drawFlatShadow(const Shadow &shadow, SkCanvas *canvas);
+    void drawInnerShadow(const Shadow &shadow, const SkPath &shape, SkCanvas *canvas);
+    void drawFills(const Fills &fills, const SkPath &shape, SkCanvas *canvas);
+    void drawStrokes(const Stroke &stroke, const SkPath &shape, SkCanvas *canvas);
+
+    void calculateRenderRect();
     QRectF calculateShadowPaths();
     void calculateInnerShadowPaths();
+    QTransform resizeTransform() const;
 
 };
 
@@ -0,0 +1,42 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef ITEMINDEX_H
+#define ITEMINDEX_H
+
+class AbstractItemBase;
+
+/*!
+ * \brief Spatial index of a scene. Items keep it up to date when their scene bounds change, the scene implements it.
+ */
+class ItemIndex
+{
+public:
+
+    virtual ~ItemIndex() {}
+
+    virtual void indexItem(AbstractItemBase *item) = 0;
+    virtual void unindexItem(AbstractItemBase *item) = 0;
+
+};
+
+#endif // ITEMINDEX_H
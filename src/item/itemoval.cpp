@@ -21,6 +21,7 @@
 **************************************************************************************/
 
 #include <itemoval.h>
+#include <qt2skia.h>
 
 ItemOval::ItemOval(QGraphicsItem *parent) : ItemOval(0,0,80,80, parent){}
 ItemOval::ItemOval(qreal x, qreal y, qreal width, qreal height, QGraphicsItem *parent) : ItemOval(QRectF(x,y,width,height), parent){}
@@ -66,6 +67,11 @@ void ItemOval::setRect(QRectF rect)
     QPainterPath path;
     path.addEllipse(rect);
     ItemBase::setShape(path);
-    calculateRenderRect();
+}
+
+bool ItemOval::isPrimitive(SkRRect &rrect) const
+{
+    rrect.setOval(skia::skRect(rect()));
+    return true;
 }
 
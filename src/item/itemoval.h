@@ -51,6 +51,7 @@ public:
 	// Properties
     int type() const override { return Type::Oval; }
     void setRect(QRectF rect) override;
+    bool isPrimitive(SkRRect &rrect) const override;
 
 };
 
@@ -21,6 +21,7 @@
 **************************************************************************************/
 
 #include <itempolygon.h>
+#include <shapetemplate.h>
 #include <QtGlobal>
 #include <QtMath>
 
@@ -55,6 +56,15 @@ bool ItemPolygon::operator==(const ItemPolygon &other) const
             ItemBase::operator==(other);
 }
 
+void ItemPolygon::writeContent(QDataStream &stream) const
+{
+    ItemBase::writeContent(stream);
+
+    stream << m_sides <<
+              m_innerRadius <<
+              m_useInnerRadius;
+}
+
 /***************************************************
  *
  * Properties
@@ -110,40 +120,12 @@ void ItemPolygon::setRect(QRectF rect)
     }
 
     ItemBase::setShape(shapeScaled(rect));
-    calculateRenderRect();
     m_rect = rect; // overide rect, because shape doesn't fillout whole rect
 }
 
 QPainterPath ItemPolygon::shapeScaled(QRectF frame) const
 {
     int points = (m_useInnerRadius) ? sides() *2 : sides();
-    qreal angle = -90.0;
-
-    QPointF center = frame.center();
-    QPointF start(center.x(), frame.top());
-
-    QPainterPath polygon(start);
-
-    for (int i=0; i < points; i++){
-
-        QPointF ellipsePoint(
-                    center.x() + frame.width()/2 * qCos(angle * M_PI/180.0),
-                    center.y() + frame.height()/2 * qSin(angle * M_PI/180.0)
-                    );
-
-
-        QLineF line;
-        line.setP1(center);
-        line.setP2(ellipsePoint);
-
-        qreal length = (i % 2 && m_useInnerRadius) ? line.length() * innerRadius(): line.length();
-        line.setLength(length);
-
-        polygon.lineTo( line.p2() );
-
-        angle +=360.0 / points;
-    }
 
-    polygon.closeSubpath();
-    return polygon;
+    return ShapeTemplate::polygon(frame, points, (m_useInnerRadius) ? innerRadius() : 1.0);
 }
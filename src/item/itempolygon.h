@@ -59,6 +59,9 @@ public:
     void setRect(QRectF rect) override;
     virtual QPainterPath shapeScaled(QRectF frame) const;
 
+protected:
+    void writeContent(QDataStream &stream) const override;
+
 private:
     int m_sides;
     qreal m_innerRadius;
@@ -22,6 +22,8 @@
 
 #include <itemrect.h>
 #include <pathprocessor.h>
+#include <qt2skia.h>
+#include <shapetemplate.h>
 
 ItemRect::ItemRect(QGraphicsItem *parent) : ItemRect(0,0,80,80, parent){}
 ItemRect::ItemRect(qreal x, qreal y, qreal width, qreal height, QGraphicsItem *parent) : ItemRect(QRectF(x,y,width,height), parent){}
@@ -57,6 +59,16 @@ bool ItemRect::operator==(const ItemRect &other) const
             ItemBase::operator==(other);
 }
 
+void ItemRect::writeContent(QDataStream &stream) const
+{
+    ItemBase::writeContent(stream);
+
+    stream << m_radiusTL <<
+              m_radiusTR <<
+              m_radiusBR <<
+              m_radiusBL;
+}
+
 /***************************************************
  *
  * Properties
@@ -95,17 +107,42 @@ void ItemRect::setRect(QRectF rect)
     }
 
     ItemBase::setShape(shapeScaled(rect)); // setRect() will set by setShape()
-    calculateRenderRect();
 }
 
-QPainterPath ItemRect::shapeScaled(QRectF frame) const
+bool ItemRect::isRoundedRect(QRectF &rect, qreal &radius) const
+{
+    if(m_radiusTL != m_radiusTR || m_radiusTL != m_radiusBR || m_radiusTL != m_radiusBL) return false;
+
+    rect = this->rect();
+    radius = qMax(0.0, qMin(m_radiusTL, qMin(rect.width(), rect.height()) / 2));
+
+    return true;
+}
+
+bool ItemRect::isPrimitive(SkRRect &rrect) const
 {
-    QPainterPath path;
+    QRectF frame = rect();
+    qreal w = frame.width() / 2;
+    qreal h = frame.height() / 2;
 
-    qreal l = frame.left();
-    qreal t = frame.top();
-    qreal r = frame.right();
-    qreal b = frame.bottom();
+    // same radius clamping as shapeScaled()
+    auto clamp = [w, h](qreal radius) -> SkScalar {
+        return (w <= 0 || h <= 0) ? 0 : SkDoubleToScalar(qMax(0.0, qMin(radius, qMin(w, h))));
+    };
+
+    const SkVector radii[4] = {
+        SkVector::Make(clamp(m_radiusTL), clamp(m_radiusTL)),
+        SkVector::Make(clamp(m_radiusTR), clamp(m_radiusTR)),
+        SkVector::Make(clamp(m_radiusBR), clamp(m_radiusBR)),
+        SkVector::Make(clamp(m_radiusBL), clamp(m_radiusBL))
+    };
+
+    rrect.setRectRadii(skia::skRect(frame), radii);
+    return true;
+}
+
+QPainterPath ItemRect::shapeScaled(QRectF frame) const
+{
     qreal w = frame.width() / 2;
     qreal h = frame.height() / 2;
     qreal tl = m_radiusTL;
@@ -140,31 +177,7 @@ QPainterPath ItemRect::shapeScaled(QRectF frame) const
         tl = qMin(tlH, tlW);
     }
 
-    tl = tl*2;
-    tr = tr*2;
-    br = br*2;
-    bl = bl*2;
-
-    path.arcMoveTo(l, t, tl, tl, 180);
-    if(tl<=0){
-        path.lineTo(l, t);
-    }else path.arcTo(l, t, tl, tl, 180, -90); // TL
-
-    if(tr<=0){
-        path.lineTo(r, t);
-    }else path.arcTo(r-tr, t, tr, tr, 90, -90); // TR
-
-    if(br<=0){
-        path.lineTo(r, b);
-    }else path.arcTo(r-br, b-br, br, br, 0, -90); // BR
-
-    if(bl<=0){
-        path.lineTo(l, b);
-    }else path.arcTo(l, b-bl, bl, bl, 270, -90); // BL
-
-    path.closeSubpath();
-
-    return path;
+    return ShapeTemplate::roundedRect(frame, tl, tr, br, bl);
 }
 
 
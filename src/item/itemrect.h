@@ -57,8 +57,13 @@ public:
 	qreal radius() const;
     void setRect(QRectF rect) override;
     virtual QPainterPath shapeScaled(QRectF frame) const;
+    bool isRoundedRect(QRectF &rect, qreal &radius) const override;
+    bool isPrimitive(SkRRect &rrect) const override;
 //    virtual QPainterPath shapeScaled2(QRectF frame, qreal scaleFactor, qreal offset = 0, Stroke stroke = Stroke("tmp",QBrush(Qt::transparent),0, StrokePosition::Center)) const;
 
+protected:
+    void writeContent(QDataStream &stream) const override;
+
 private:
 
 	qreal m_radiusTL;
@@ -29,6 +29,7 @@
 #include <QTextFrameFormat>
 #include <QTextBlockFormat>
 #include <qabstracttextdocumentlayout.h>
+#include <profiler.h>
 
 
 
@@ -74,6 +75,17 @@ bool ItemText::operator==(const ItemText &other) const
             ItemBase::operator==(other);
 }
 
+void ItemText::writeContent(QDataStream &stream) const
+{
+    ItemBase::writeContent(stream);
+
+    stream << m_text->toHtml() <<
+              m_text->defaultFont() <<
+              m_color <<
+              m_lineHeight <<
+              (int)alignment();
+}
+
 void ItemText::setRect(QRectF rect)
 {
 
@@ -103,8 +115,6 @@ void ItemText::setRect(QRectF rect)
     QPainterPath path;
     path.addRect(rect);
     ItemBase::setShape(path);
-
-    calculateRenderRect();
 }
 
 void ItemText::setText(const QString text)
@@ -327,6 +337,10 @@ void ItemText::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
 {
     ItemBase::paint(painter, option, widget);
 
+    if(isCulled()) return;
+
+    PROFILE_ITEM_SCOPE("ItemText::drawText", "text", name());
+
     // reset painter state, like select, edit etc.
     QStyleOptionGraphicsItem *opt = new QStyleOptionGraphicsItem();
 
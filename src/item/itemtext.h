@@ -84,6 +84,8 @@ private:
 //    QList<QList<QTextLayout::FormatRange> > formats;
 
 protected:
+    void writeContent(QDataStream &stream) const override;
+
     //	virtual void focusOutEvent (QFocusEvent * event);
     //	virtual void mouseDoubleClickEvent(QGraphicsSceneMouseEvent * event);
 
@@ -0,0 +1,310 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "blurprocessor.h"
+
+#include <QtMath>
+#include <QVector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Number of box passes used to approximate the gaussian
+static const int BoxPasses = 3;
+
+/***************************************************
+ *
+ * Row kernels
+ *
+ ***************************************************/
+
+/*!
+ * \brief Adds (sign = 1) or subtracts (sign = -1) a row of alpha values to the running column sums.
+ */
+static inline void accumulateRow(int *acc, const uchar *row, int width, int sign)
+{
+    int x = 0;
+
+#if defined(__AVX2__)
+    for(; x + 8 <= width; x += 8){
+        __m256i value = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + x)));
+        __m256i sum = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + x));
+        sum = (sign > 0) ? _mm256_add_epi32(sum, value) : _mm256_sub_epi32(sum, value);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + x), sum);
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for(; x + 16 <= width; x += 16){
+        __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+        __m128i lo = _mm_unpacklo_epi8(value, zero);
+        __m128i hi = _mm_unpackhi_epi8(value, zero);
+        __m128i v[4] = { _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+                         _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero) };
+        for(int i = 0; i < 4; ++i){
+            __m128i *ptr = reinterpret_cast<__m128i*>(acc + x + i * 4);
+            __m128i sum = _mm_loadu_si128(ptr);
+            sum = (sign > 0) ? _mm_add_epi32(sum, v[i]) : _mm_sub_epi32(sum, v[i]);
+            _mm_storeu_si128(ptr, sum);
+        }
+    }
+#elif defined(__ARM_NEON)
+    for(; x + 8 <= width; x += 8){
+        uint16x8_t value = vmovl_u8(vld1_u8(row + x));
+        int32x4_t lo = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(value)));
+        int32x4_t hi = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(value)));
+        int32x4_t sumLo = vld1q_s32(acc + x);
+        int32x4_t sumHi = vld1q_s32(acc + x + 4);
+        if(sign > 0){
+            sumLo = vaddq_s32(sumLo, lo);
+            sumHi = vaddq_s32(sumHi, hi);
+        }else{
+            sumLo = vsubq_s32(sumLo, lo);
+            sumHi = vsubq_s32(sumHi, hi);
+        }
+        vst1q_s32(acc + x, sumLo);
+        vst1q_s32(acc + x + 4, sumHi);
+    }
+#endif
+
+    for(; x < width; ++x){
+        acc[x] += sign * row[x];
+    }
+}
+
+/*!
+ * \brief Writes the averaged column sums into a destination row.
+ */
+static inline void storeRow(const int *acc, uchar *dst, int width, float scale)
+{
+    int x = 0;
+
+#if defined(__AVX2__)
+    const __m256 factor = _mm256_set1_ps(scale);
+    for(; x + 8 <= width; x += 8){
+        __m256 value = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + x)));
+        __m256i result = _mm256_cvtps_epi32(_mm256_mul_ps(value, factor));
+        __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(result), _mm256_extracti128_si256(result, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(packed, packed));
+    }
+#elif defined(__SSE2__)
+    const __m128 factor = _mm_set1_ps(scale);
+    for(; x + 16 <= width; x += 16){
+        __m128i v[4];
+        for(int i = 0; i < 4; ++i){
+            __m128 value = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + x + i * 4)));
+            v[i] = _mm_cvtps_epi32(_mm_mul_ps(value, factor));
+        }
+        __m128i lo = _mm_packs_epi32(v[0], v[1]);
+        __m128i hi = _mm_packs_epi32(v[2], v[3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(lo, hi));
+    }
+#elif defined(__ARM_NEON)
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    for(; x + 8 <= width; x += 8){
+        float32x4_t lo = vmlaq_n_f32(half, vcvtq_f32_s32(vld1q_s32(acc + x)), scale);
+        float32x4_t hi = vmlaq_n_f32(half, vcvtq_f32_s32(vld1q_s32(acc + x + 4)), scale);
+        uint16x8_t packed = vcombine_u16(vqmovn_u32(vcvtq_u32_f32(lo)), vqmovn_u32(vcvtq_u32_f32(hi)));
+        vst1_u8(dst + x, vqmovn_u16(packed));
+    }
+#endif
+
+    for(; x < width; ++x){
+        dst[x] = static_cast<uchar>(qMin(255, qRound(acc[x] * scale)));
+    }
+}
+
+/***************************************************
+ *
+ * Public
+ *
+ ***************************************************/
+
+/*!
+ * \brief Blurs an alpha mask in place. The mask has to be of format QImage::Format_Alpha8.
+ * The gaussian is approximated by three box blurs, each done as a vertical running sum pass.
+ * Horizontal passes reuse the same kernel on a transposed copy. Pixels outside of the image are treated as transparent.
+ * \param mask
+ * \param radius blur radius in device pixels (sigma = radius / 2)
+ */
+void BlurProcessor::blur(QImage &mask, qreal radius)
+{
+    Q_ASSERT(mask.format() == QImage::Format_Alpha8);
+
+    const int width = mask.width();
+    const int height = mask.height();
+
+    if(radius < 0.5 || width < 2 || height < 2) return;
+
+    int sizes[BoxPasses];
+    boxSizes(radius / 2.0, sizes, BoxPasses);
+
+    // tightly packed ping pong buffers
+    QVector<uchar> bufferA(width * height);
+    QVector<uchar> bufferB(width * height);
+    QVector<int> acc(qMax(width, height));
+
+    uchar *a = bufferA.data();
+    uchar *b = bufferB.data();
+
+    for(int y = 0; y < height; ++y){
+        memcpy(a + y * width, mask.constScanLine(y), static_cast<size_t>(width));
+    }
+
+    // vertical passes
+    for(int i = 0; i < BoxPasses; ++i){
+        blurColumns(a, b, acc.data(), width, height, (sizes[i] - 1) / 2);
+        qSwap(a, b);
+    }
+
+    // horizontal passes
+    transpose(a, width, b, height, width, height);
+    qSwap(a, b);
+
+    for(int i = 0; i < BoxPasses; ++i){
+        blurColumns(a, b, acc.data(), height, width, (sizes[i] - 1) / 2);
+        qSwap(a, b);
+    }
+
+    transpose(a, height, mask.bits(), mask.bytesPerLine(), height, width);
+}
+
+
+/*!
+ * \brief Converts a blurred alpha mask into a premultiplied image of the given color.
+ * \param mask alpha mask of format QImage::Format_Alpha8
+ * \param color
+ * \param invert use the inverted alpha (inner shadows)
+ * \return
+ */
+QImage BlurProcessor::tint(const QImage &mask, const QColor &color, bool invert)
+{
+    Q_ASSERT(mask.format() == QImage::Format_Alpha8);
+
+    QImage image(mask.size(), QImage::Format_ARGB32_Premultiplied);
+
+    const QRgb rgba = qPremultiply(color.rgba());
+    const uint ag = (rgba >> 8) & 0x00ff00ff;
+    const uint rb = rgba & 0x00ff00ff;
+
+    for(int y = 0; y < mask.height(); ++y){
+        const uchar *src = mask.constScanLine(y);
+        QRgb *dst = reinterpret_cast<QRgb*>(image.scanLine(y));
+
+        for(int x = 0; x < mask.width(); ++x){
+            const uint alpha = invert ? 255 - src[x] : src[x];
+
+            // two channels per multiplication, see BYTE_MUL in qdrawhelper
+            uint t = rb * alpha;
+            t = (t + ((t >> 8) & 0x00ff00ff) + 0x00800080) >> 8;
+            uint u = ag * alpha;
+            u = (u + ((u >> 8) & 0x00ff00ff) + 0x00800080);
+
+            dst[x] = (t & 0x00ff00ff) | (u & 0xff00ff00);
+        }
+    }
+
+    return image;
+}
+
+/***************************************************
+ *
+ * Private
+ *
+ ***************************************************/
+
+/*!
+ * \brief Calculates the box sizes to approximate a gaussian with the given sigma.
+ * http://blog.ivank.net/fastest-gaussian-blur.html
+ */
+void BlurProcessor::boxSizes(qreal sigma, int *sizes, int count)
+{
+    const qreal wIdeal = qSqrt((12.0 * sigma * sigma / count) + 1.0);
+    int wl = qFloor(wIdeal);
+    if(wl % 2 == 0) wl--;
+    const int wu = wl + 2;
+
+    const qreal mIdeal = (12.0 * sigma * sigma - count * wl * wl - 4.0 * count * wl - 3.0 * count) / (-4.0 * wl - 4.0);
+    const int m = qRound(mIdeal);
+
+    for(int i = 0; i < count; ++i){
+        sizes[i] = (i < m) ? wl : wu;
+    }
+}
+
+
+/*!
+ * \brief Box blurs all columns of a tightly packed buffer at once.
+ * Every output row is a running sum of 2 * radius + 1 input rows, which vectorizes over the row width.
+ */
+void BlurProcessor::blurColumns(const uchar *src, uchar *dst, int *acc, int width, int height, int radius)
+{
+    if(radius <= 0){
+        memcpy(dst, src, static_cast<size_t>(width * height));
+        return;
+    }
+
+    const float scale = 1.0f / (2 * radius + 1);
+
+    memset(acc, 0, sizeof(int) * static_cast<size_t>(width));
+
+    // prefill with the rows below the first output row
+    for(int y = 0; y < qMin(radius, height); ++y){
+        accumulateRow(acc, src + y * width, width, 1);
+    }
+
+    for(int y = 0; y < height; ++y){
+        const int add = y + radius;
+        const int sub = y - radius - 1;
+
+        if(add < height) accumulateRow(acc, src + add * width, width, 1);
+        if(sub >= 0) accumulateRow(acc, src + sub * width, width, -1);
+
+        storeRow(acc, dst + y * width, width, scale);
+    }
+}
+
+
+/*!
+ * \brief Transposes a byte buffer in cache friendly blocks.
+ */
+void BlurProcessor::transpose(const uchar *src, int srcStride, uchar *dst, int dstStride, int width, int height)
+{
+    const int block = 32;
+
+    for(int by = 0; by < height; by += block){
+        const int yEnd = qMin(by + block, height);
+        for(int bx = 0; bx < width; bx += block){
+            const int xEnd = qMin(bx + block, width);
+            for(int y = by; y < yEnd; ++y){
+                const uchar *s = src + y * srcStride;
+                for(int x = bx; x < xEnd; ++x){
+                    dst[x * dstStride + y] = s[x];
+                }
+            }
+        }
+    }
+}
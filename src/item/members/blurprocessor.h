@@ -0,0 +1,44 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef BLURPROCESSOR_H
+#define BLURPROCESSOR_H
+
+#include <QImage>
+#include <QColor>
+
+class BlurProcessor
+{
+public:
+
+    static void blur(QImage &mask, qreal radius);
+    static QImage tint(const QImage &mask, const QColor &color, bool invert = false);
+
+private:
+
+    static void boxSizes(qreal sigma, int *sizes, int count);
+    static void blurColumns(const uchar *src, uchar *dst, int *acc, int width, int height, int radius);
+    static void transpose(const uchar *src, int srcStride, uchar *dst, int dstStride, int width, int height);
+
+};
+
+#endif // BLURPROCESSOR_H
@@ -37,7 +37,8 @@ public:
         JPG = 0,
         PNG = 1,
         SVG = 2,
-        PDF = 3
+        PDF = 3,
+        Atlas = 4
     };
 
     enum PathType{
@@ -0,0 +1,390 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "offsetprocessor.h"
+#include "qt2skia.h"
+#include "skia2qt.h"
+#include "profiler.h"
+
+#include <QtMath>
+#include <algorithm>
+
+/***************************************************
+ *
+ * Helper
+ *
+ ***************************************************/
+
+static inline QPointF toPoint(const SkPoint &point)
+{
+    return QPointF(static_cast<qreal>(point.x()), static_cast<qreal>(point.y()));
+}
+
+static inline qreal length(const QPointF &point)
+{
+    return qSqrt(QPointF::dotProduct(point, point));
+}
+
+/*!
+ * \brief Number of line segments needed to keep a quad within tolerance (Wang's formula).
+ */
+static inline int quadSegments(const QPointF &p0, const QPointF &p1, const QPointF &p2, qreal tolerance)
+{
+    const qreal dd = length(p0 - 2 * p1 + p2);
+    return qBound(1, qCeil(qSqrt(dd / (4 * tolerance))), 256);
+}
+
+/*!
+ * \brief Number of line segments needed to keep a cubic within tolerance (Wang's formula).
+ */
+static inline int cubicSegments(const QPointF &p0, const QPointF &p1, const QPointF &p2, const QPointF &p3, qreal tolerance)
+{
+    const qreal dd = qMax(length(p0 - 2 * p1 + p2), length(p1 - 2 * p2 + p3));
+    return qBound(1, qCeil(qSqrt(0.75 * dd / tolerance)), 256);
+}
+
+static void appendQuad(QPolygonF &polygon, const QPointF &p0, const QPointF &p1, const QPointF &p2, qreal tolerance)
+{
+    const int segments = quadSegments(p0, p1, p2, tolerance);
+
+    for(int i = 1; i <= segments; ++i){
+        const qreal t = qreal(i) / segments;
+        const qreal mt = 1 - t;
+        polygon.append(mt * mt * p0 + 2 * mt * t * p1 + t * t * p2);
+    }
+}
+
+static void appendCubic(QPolygonF &polygon, const QPointF &p0, const QPointF &p1, const QPointF &p2, const QPointF &p3, qreal tolerance)
+{
+    const int segments = cubicSegments(p0, p1, p2, p3, tolerance);
+
+    for(int i = 1; i <= segments; ++i){
+        const qreal t = qreal(i) / segments;
+        const qreal mt = 1 - t;
+        polygon.append(mt * mt * mt * p0 + 3 * mt * mt * t * p1 + 3 * mt * t * t * p2 + t * t * t * p3);
+    }
+}
+
+/*!
+ * \brief Drops repeated points and the closing point, which equals the first one.
+ */
+static void appendContour(QList<QPolygonF> &contours, QPolygonF &polygon)
+{
+    QPolygonF clean;
+    clean.reserve(polygon.size());
+
+    foreach(const QPointF &point, polygon){
+        if(clean.isEmpty() || clean.last() != point) clean.append(point);
+    }
+
+    while(clean.size() > 1 && clean.first() == clean.last()) clean.removeLast();
+
+    if(clean.size() > 2) contours.append(clean);
+    polygon.clear();
+}
+
+/***************************************************
+ *
+ * Public
+ *
+ ***************************************************/
+
+QPainterPath OffsetProcessor::offset(const QPainterPath &path, qreal distance, qreal tolerance)
+{
+    if(qFuzzyIsNull(distance) || path.isEmpty()) return path;
+
+    return skia::qtPath( offset(skia::skPath(path), distance, tolerance) );
+}
+
+
+/*!
+ * \brief Grows (distance > 0) or shrinks (distance < 0) a filled path by distance on each side.
+ * \param path
+ * \param distance
+ * \param tolerance maximal flattening error of curves
+ * \param miterLimit corners with longer miters get beveled
+ * \return
+ */
+SkPath OffsetProcessor::offset(const SkPath &path, qreal distance, qreal tolerance, qreal miterLimit)
+{
+    PROFILE_COUNT("OffsetProcessor::offset");
+
+    if(qFuzzyIsNull(distance) || path.isEmpty()) return path;
+
+    // curve flattening divides by the tolerance
+    tolerance = qMax(tolerance, 0.001);
+
+    // exact results for primitives
+    if(!path.isInverseFillType()){
+        SkRect rect;
+        SkRRect rrect;
+
+        if(path.isRect(&rect)) return offset(SkRRect::MakeRect(rect), distance);
+        if(path.isOval(&rect)) return offset(SkRRect::MakeOval(rect), distance);
+        if(path.isRRect(&rrect)) return offset(rrect, distance);
+    }
+
+    QList<QPolygonF> contours = flatten(path, tolerance);
+    if(contours.isEmpty()) return SkPath();
+
+    // Growing relies on outer contours and holes running in opposite directions.
+    // Simplify a polygon is cheap compared to a curved path, single contours are fine anyway.
+    if(contours.size() > 1){
+        SkPath simple;
+        if(Simplify(polygonPath(contours), &simple)) contours = flatten(simple, tolerance);
+        if(contours.isEmpty()) return SkPath();
+    }
+
+    SkPath result;
+
+    if(distance > 0){
+        Simplify(grow(contours, distance, miterLimit), &result);
+    }else{
+        // Shrinking is growing the complement inside of a frame. Collapsing parts vanish instead of
+        // turning into inverted loops, which a nonzero fill would keep.
+        QRectF bounds = contours.first().boundingRect();
+        foreach(const QPolygonF &contour, contours){
+            bounds = bounds.united(contour.boundingRect());
+        }
+
+        const qreal margin = -distance * 2 + 1;
+        bounds.adjust(-margin, -margin, margin, margin);
+
+        int outer = 0;
+        for(int i = 1; i < contours.size(); ++i){
+            if(qAbs(area(contours.at(i))) > qAbs(area(contours.at(outer)))) outer = i;
+        }
+
+        QPolygonF frame(bounds);
+        frame.removeLast();
+        if((area(frame) > 0) != (area(contours.at(outer)) > 0)) std::reverse(frame.begin(), frame.end());
+
+        QList<QPolygonF> complement;
+        complement.append(frame);
+        foreach(QPolygonF contour, contours){
+            std::reverse(contour.begin(), contour.end());
+            complement.append(contour);
+        }
+
+        SkPath framePath;
+        framePath.addRect(skia::skRect(bounds));
+
+        Op(framePath, grow(complement, -distance, miterLimit), SkPathOp::kDifference_SkPathOp, &result);
+    }
+
+    return result;
+}
+
+
+/*!
+ * \brief Offsets a rect, rounded rect or ellipse analytically.
+ * Rects and rounded rects are exact, radii grow or shrink by distance and sharp corners stay sharp.
+ * Non circular ellipses keep their shape, which deviates from the true parallel curve by a fraction of distance.
+ * \param rrect
+ * \param distance
+ * \return
+ */
+SkPath OffsetProcessor::offset(const SkRRect &rrect, qreal distance)
+{
+    PROFILE_COUNT("OffsetProcessor::offset");
+
+    SkRRect result;
+    const SkScalar d = SkDoubleToScalar(qAbs(distance));
+
+    if(distance > 0) rrect.outset(d, d, &result);
+    else rrect.inset(d, d, &result);
+
+    SkPath path;
+    if(!result.isEmpty()) path.addRRect(result);
+    return path;
+}
+
+
+/*!
+ * \brief Flattens all contours of a path into closed polygons.
+ * \param path
+ * \param tolerance maximal distance between curve and polygon
+ * \return
+ */
+QList<QPolygonF> OffsetProcessor::flatten(const SkPath &path, qreal tolerance)
+{
+    QList<QPolygonF> contours;
+    QPolygonF polygon;
+
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+
+    while((verb = iter.next(pts)) != SkPath::kDone_Verb){
+        switch(verb){
+        case SkPath::kMove_Verb:
+            appendContour(contours, polygon);
+            polygon.append(toPoint(pts[0]));
+            break;
+        case SkPath::kLine_Verb:
+            polygon.append(toPoint(pts[1]));
+            break;
+        case SkPath::kQuad_Verb:
+            appendQuad(polygon, toPoint(pts[0]), toPoint(pts[1]), toPoint(pts[2]), tolerance);
+            break;
+        case SkPath::kConic_Verb:{
+            SkPoint quads[1 + 2 * (1 << 3)];
+            const int count = SkPath::ConvertConicToQuads(pts[0], pts[1], pts[2], iter.conicWeight(), quads, 3);
+            for(int i = 0; i < count; ++i){
+                appendQuad(polygon, toPoint(quads[i * 2]), toPoint(quads[i * 2 + 1]), toPoint(quads[i * 2 + 2]), tolerance);
+            }
+            break;
+        }
+        case SkPath::kCubic_Verb:
+            appendCubic(polygon, toPoint(pts[0]), toPoint(pts[1]), toPoint(pts[2]), toPoint(pts[3]), tolerance);
+            break;
+        case SkPath::kClose_Verb:
+            appendContour(contours, polygon);
+            break;
+        default:
+            break;
+        }
+    }
+
+    appendContour(contours, polygon);
+
+    return contours;
+}
+
+/***************************************************
+ *
+ * Private
+ *
+ ***************************************************/
+
+/*!
+ * \brief Moves all contours outwards by distance. The result may overlap itself and has to be resolved with nonzero fill.
+ */
+SkPath OffsetProcessor::grow(const QList<QPolygonF> &contours, qreal distance, qreal miterLimit)
+{
+    // the largest contour is an outer one, its direction defines which side is outside
+    int outer = 0;
+    for(int i = 1; i < contours.size(); ++i){
+        if(qAbs(area(contours.at(i))) > qAbs(area(contours.at(outer)))) outer = i;
+    }
+
+    const qreal sign = (area(contours.at(outer)) > 0) ? 1 : -1;
+
+    SkPath result;
+    result.setFillType(SkPathFillType::kWinding);
+
+    foreach(const QPolygonF &contour, contours){
+        growContour(contour, distance, sign, miterLimit, result);
+    }
+
+    return result;
+}
+
+
+/*!
+ * \brief Offsets a single closed polygon, see ClipperOffset::OffsetPoint.
+ * Convex corners get a miter or bevel, concave corners get the original vertex inserted,
+ * which keeps the loops they produce inside the filled area.
+ */
+void OffsetProcessor::growContour(const QPolygonF &contour, qreal distance, qreal sign, qreal miterLimit, SkPath &result)
+{
+    const int count = contour.size();
+    if(count < 3) return;
+
+    // outward unit normals per edge
+    QVector<QPointF> normals(count);
+    for(int i = 0; i < count; ++i){
+        const QPointF edge = contour.at((i + 1) % count) - contour.at(i);
+        const qreal len = length(edge);
+        normals[i] = (len > 0) ? QPointF(edge.y(), -edge.x()) * (sign / len) : QPointF();
+    }
+
+    const qreal miterThreshold = 2.0 / (miterLimit * miterLimit);
+    bool first = true;
+
+    auto add = [&](const QPointF &point){
+        const SkPoint p = SkPoint::Make(SkDoubleToScalar(point.x()), SkDoubleToScalar(point.y()));
+        if(first) result.moveTo(p);
+        else result.lineTo(p);
+        first = false;
+    };
+
+    for(int i = 0; i < count; ++i){
+        const QPointF &point = contour.at(i);
+        const QPointF &n1 = normals.at((i + count - 1) % count);
+        const QPointF &n2 = normals.at(i);
+
+        const qreal sinA = n1.x() * n2.y() - n1.y() * n2.x();
+        const qreal cosA = QPointF::dotProduct(n1, n2);
+
+        if(qAbs(sinA) < 1e-9 && cosA > 0){
+            // collinear
+            add(point + n2 * distance);
+        }else if(sinA * sign < 0){
+            // concave
+            add(point + n1 * distance);
+            add(point);
+            add(point + n2 * distance);
+        }else if(1 + cosA >= miterThreshold){
+            add(point + (n1 + n2) * (distance / (1 + cosA)));
+        }else{
+            add(point + n1 * distance);
+            add(point + n2 * distance);
+        }
+    }
+
+    result.close();
+}
+
+
+SkPath OffsetProcessor::polygonPath(const QList<QPolygonF> &contours)
+{
+    SkPath path;
+
+    foreach(const QPolygonF &contour, contours){
+        path.moveTo(skia::skPoint(contour.first()));
+        for(int i = 1; i < contour.size(); ++i){
+            path.lineTo(skia::skPoint(contour.at(i)));
+        }
+        path.close();
+    }
+
+    return path;
+}
+
+
+/*!
+ * \brief Signed area of a closed polygon (shoelace formula).
+ */
+qreal OffsetProcessor::area(const QPolygonF &contour)
+{
+    qreal sum = 0;
+    const int count = contour.size();
+
+    for(int i = 0; i < count; ++i){
+        const QPointF &a = contour.at(i);
+        const QPointF &b = contour.at((i + 1) % count);
+        sum += a.x() * b.y() - b.x() * a.y();
+    }
+
+    return sum / 2;
+}
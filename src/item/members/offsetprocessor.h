@@ -0,0 +1,60 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef OFFSETPROCESSOR_H
+#define OFFSETPROCESSOR_H
+
+#include <QPainterPath>
+#include <QPolygonF>
+#include <QList>
+#include <skia_includes.h>
+
+/*!
+ * \brief Grows or shrinks filled shapes by a distance on each side, with mitered corners.
+ * Rects, rounded rects and ellipses are offset analytically. All other shapes are flattened to polygons,
+ * offset vertex by vertex and cleaned up with a single path operation.
+ */
+class OffsetProcessor
+{
+public:
+
+    // maximal distance of flattened curves to the original curve in item coordinates
+    static constexpr qreal DefaultTolerance = 0.1;
+    // maximal miter length as multiple of the distance, same as QPen default
+    static constexpr qreal DefaultMiterLimit = 2.0;
+
+    static QPainterPath offset(const QPainterPath &path, qreal distance, qreal tolerance = DefaultTolerance);
+    static SkPath offset(const SkPath &path, qreal distance, qreal tolerance = DefaultTolerance, qreal miterLimit = DefaultMiterLimit);
+    static SkPath offset(const SkRRect &rrect, qreal distance);
+
+    static QList<QPolygonF> flatten(const SkPath &path, qreal tolerance = DefaultTolerance);
+
+private:
+
+    static SkPath grow(const QList<QPolygonF> &contours, qreal distance, qreal miterLimit);
+    static void growContour(const QPolygonF &contour, qreal distance, qreal sign, qreal miterLimit, SkPath &result);
+    static SkPath polygonPath(const QList<QPolygonF> &contours);
+    static qreal area(const QPolygonF &contour);
+
+};
+
+#endif // OFFSETPROCESSOR_H
@@ -24,8 +24,11 @@
 #include "skia_includes.h"
 #include "qt2skia.h"
 #include "skia2qt.h"
+#include "offsetprocessor.h"
+#include "profiler.h"
 
 #include <QDebug>
+#include <QVector>
 
 QPainterPath PathProcessor::combine(const QPainterPath &path1, const QPainterPath &path2, PathProcessor::Booleans boolOperator)
 {
@@ -38,51 +41,86 @@ QPainterPath PathProcessor::combine(const QPainterPath &path1, const QPainterPat
 
 SkPath PathProcessor::combine(const SkPath &path1, const SkPath &path2, PathProcessor::Booleans boolOperator)
 {
+    PROFILE_COUNT("PathProcessor::combine");
+
     SkPath result;
+    Op(path1, path2, skPathOp(boolOperator), &result);
 
-    //    kDifference_SkPathOp,         //!< subtract the op path from the first path
-    //    kIntersect_SkPathOp,          //!< intersect the two paths
-    //    kUnion_SkPathOp,              //!< union (inclusive-or) the two paths
-    //    kXOR_SkPathOp,                //!< exclusive-or the two paths
-    //    kReverseDifference_SkPathOp,  //!< subtract the first path from the op path
+    return simplify(result);
+}
 
-    switch (boolOperator) {
-    case Booleans::Subtract:
-        Op(path1, path2, SkPathOp::kDifference_SkPathOp, &result);
-        break;
-    case Booleans::Intersect:
-        Op(path1, path2, SkPathOp::kIntersect_SkPathOp, &result);
-        break;
-    case Booleans::InvertIntersect:
-        Op(path1, path2, SkPathOp::kXOR_SkPathOp, &result);
-        break;
-    case Booleans::Unite:
-    default:
-        Op(path1, path2, SkPathOp::kUnion_SkPathOp, &result);
-        break;
+
+QPainterPath PathProcessor::combineMany(const QList<QPainterPath> &paths, PathProcessor::Booleans boolOperator)
+{
+    QList<SkPath> skPaths;
+    skPaths.reserve(paths.size());
+
+    foreach(const QPainterPath &path, paths){
+        skPaths.append(skia::skPath(path));
     }
 
-    return simplify(result);
+    return skia::qtPath( combineMany(skPaths, boolOperator) );
 }
 
 
-QPainterPath PathProcessor::scale( const QPainterPath & path, qreal amount){
+/*!
+ * \brief Applies the same boolean operation to all paths in a single pass.
+ * The first path is the base, all following paths are operands, e.g. first - second - third for Subtract.
+ * \param paths
+ * \param boolOperator
+ * \return
+ */
+SkPath PathProcessor::combineMany(const QList<SkPath> &paths, PathProcessor::Booleans boolOperator)
+{
+    QList<QPair<SkPath, Booleans> > operands;
+    operands.reserve(paths.size());
+
+    foreach(const SkPath &path, paths){
+        operands.append(qMakePair(path, boolOperator));
+    }
+
+    return combineMany(operands);
+}
+
+
+/*!
+ * \brief Resolves a boolean group of any size with SkOpBuilder.
+ * Unlike chained combine() calls no intermediate result is built and simplified.
+ * The operator of the first operand is ignored, it is the base of the group.
+ * \param operands
+ * \return
+ */
+SkPath PathProcessor::combineMany(const QList<QPair<SkPath, PathProcessor::Booleans> > &operands)
+{
+    PROFILE_COUNT("PathProcessor::combineMany");
 
-    QPainterPathStroker stroker;
-    stroker.setJoinStyle(Qt::PenJoinStyle::MiterJoin);
-    // Stroke width of PathStroker will be 50% of each side
+    if(operands.isEmpty()) return SkPath();
+    if(operands.size() == 1) return simplify(operands.first().first);
 
-    if(amount > 0){
-        stroker.setWidth( amount );
-        const QPainterPath stroked = stroker.createStroke( path );
-        return combine(path, stroked, PathProcessor::Booleans::Unite);
-    }else if(amount < 0){
-        stroker.setWidth( -amount );
-        const QPainterPath stroked = stroker.createStroke( path );
-        return combine(path, stroked, PathProcessor::Booleans::Subtract);
-    }else return path;
+    SkOpBuilder builder;
 
+    for(int i = 0; i < operands.size(); ++i){
+        const QPair<SkPath, Booleans> &operand = operands.at(i);
+        builder.add(operand.first, (i == 0) ? SkPathOp::kUnion_SkPathOp : skPathOp(operand.second));
+    }
 
+    SkPath result;
+    builder.resolve(&result);
+    return result;
+}
+
+
+/*!
+ * \brief Grows (amount > 0) or shrinks (amount < 0) a path. Amount is the full width, each side moves by amount / 2.
+ * \param path
+ * \param amount
+ * \return
+ */
+QPainterPath PathProcessor::scale( const QPainterPath & path, qreal amount){
+
+    if(qFuzzyIsNull(amount)) return path;
+
+    return OffsetProcessor::offset(path, amount / 2);
 }
 
 QPainterPath PathProcessor::simplify(QPainterPath path)
@@ -92,6 +130,8 @@ QPainterPath PathProcessor::simplify(QPainterPath path)
 
 SkPath PathProcessor::simplify(SkPath path)
 {
+    PROFILE_COUNT("PathProcessor::simplify");
+
     SkPath result;
     Simplify(path, &result);
     return result;
@@ -109,3 +149,135 @@ SkPath PathProcessor::map(SkMatrix matrix, SkPath sourcePath)
     return path;
 
 }
+
+
+/*!
+ * \brief Returns the filled outline of a stroked path. Cap, join, miter limit and dash pattern are taken from the pen.
+ * \param path
+ * \param pen
+ * \param width stroke width, replaces the pen width
+ * \return
+ */
+SkPath PathProcessor::stroke(const SkPath &path, const QPen &pen, qreal width)
+{
+    PROFILE_COUNT("PathProcessor::stroke");
+
+    SkPaint paint;
+    skia::skStroke(paint, pen, width);
+
+    SkPath result;
+    paint.getFillPath(path, &result);
+    result.setFillType(SkPathFillType::kWinding);
+    return result;
+}
+
+
+/*!
+ * \brief Maps the boolean operator to the Skia path operation.
+ */
+SkPathOp PathProcessor::skPathOp(PathProcessor::Booleans boolOperator)
+{
+    //    kDifference_SkPathOp,         //!< subtract the op path from the first path
+    //    kIntersect_SkPathOp,          //!< intersect the two paths
+    //    kUnion_SkPathOp,              //!< union (inclusive-or) the two paths
+    //    kXOR_SkPathOp,                //!< exclusive-or the two paths
+    //    kReverseDifference_SkPathOp,  //!< subtract the first path from the op path
+
+    switch (boolOperator) {
+    case Booleans::Subtract:
+        return SkPathOp::kDifference_SkPathOp;
+    case Booleans::Intersect:
+        return SkPathOp::kIntersect_SkPathOp;
+    case Booleans::InvertIntersect:
+        return SkPathOp::kXOR_SkPathOp;
+    case Booleans::Unite:
+    default:
+        return SkPathOp::kUnion_SkPathOp;
+    }
+}
+
+
+/***************************************************
+ *
+ * Pipeline
+ *
+ ***************************************************/
+
+PathProcessor::Pipeline::Pipeline()
+{
+}
+
+PathProcessor::Pipeline::Pipeline(const QPainterPath &path) : m_path(skia::skPath(path))
+{
+}
+
+PathProcessor::Pipeline::Pipeline(const SkPath &path) : m_path(path)
+{
+}
+
+/*!
+ * \brief Replaces the path by its stroke outline.
+ */
+PathProcessor::Pipeline &PathProcessor::Pipeline::stroke(const QPen &pen, qreal width)
+{
+    m_path = PathProcessor::stroke(m_path, pen, width);
+    return *this;
+}
+
+PathProcessor::Pipeline &PathProcessor::Pipeline::combine(const QPainterPath &path, PathProcessor::Booleans boolOperator)
+{
+    return combine(skia::skPath(path), boolOperator);
+}
+
+/*!
+ * \brief Applies a boolean operation with path as second operand. Path ops results are already simple,
+ * so unlike PathProcessor::combine() no additional simplify pass is done.
+ */
+PathProcessor::Pipeline &PathProcessor::Pipeline::combine(const SkPath &path, PathProcessor::Booleans boolOperator)
+{
+    PROFILE_COUNT("PathProcessor::combine");
+
+    // union with an empty accumulator is the operand itself
+    if(m_path.isEmpty() && boolOperator == Booleans::Unite){
+        m_path = path;
+        return *this;
+    }
+
+    SkPath result;
+    if(Op(m_path, path, skPathOp(boolOperator), &result)) m_path = result;
+    return *this;
+}
+
+PathProcessor::Pipeline &PathProcessor::Pipeline::simplify()
+{
+    PROFILE_COUNT("PathProcessor::simplify");
+
+    SkPath result;
+    if(Simplify(m_path, &result)) m_path = result;
+    return *this;
+}
+
+/*!
+ * \brief Grows (distance > 0) or shrinks (distance < 0) the path by distance on each side, see OffsetProcessor.
+ */
+PathProcessor::Pipeline &PathProcessor::Pipeline::offset(qreal distance)
+{
+    m_path = OffsetProcessor::offset(m_path, distance);
+    return *this;
+}
+
+PathProcessor::Pipeline &PathProcessor::Pipeline::map(const QTransform &transform)
+{
+    m_path.transform(skia::skMatrix(transform));
+    return *this;
+}
+
+const SkPath &PathProcessor::Pipeline::path() const
+{
+    return m_path;
+}
+
+QPainterPath PathProcessor::Pipeline::toPath() const
+{
+    return skia::qtPath(m_path);
+}
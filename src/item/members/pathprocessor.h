@@ -25,6 +25,9 @@
 
 #include <QPainterPath>
 #include <QTransform>
+#include <QPen>
+#include <QList>
+#include <QPair>
 #include <skia_includes.h>
 
 class PathProcessor
@@ -39,6 +42,9 @@ public:
 
     static QPainterPath combine(const QPainterPath &path1, const QPainterPath &path2, Booleans boolOperator = Booleans::Unite);
     static SkPath combine(const SkPath &path1, const SkPath &path2, Booleans boolOperator = Booleans::Unite);
+    static QPainterPath combineMany(const QList<QPainterPath> &paths, Booleans boolOperator = Booleans::Unite);
+    static SkPath combineMany(const QList<SkPath> &paths, Booleans boolOperator = Booleans::Unite);
+    static SkPath combineMany(const QList<QPair<SkPath, Booleans> > &operands);
 
     static QPainterPath scale( const QPainterPath &path, qreal amount);
 
@@ -48,6 +54,36 @@ public:
     static QPainterPath map(QTransform transform, QPainterPath sourcePath);
     static SkPath map(SkMatrix matrix, SkPath sourcePath);
 
+    /*!
+     * \brief Chain of path operations which keeps all intermediate results as SkPath.
+     * The result is converted to a QPainterPath only when toPath() is called.
+     */
+    class Pipeline
+    {
+    public:
+        Pipeline();
+        Pipeline(const QPainterPath &path);
+        Pipeline(const SkPath &path);
+
+        Pipeline &stroke(const QPen &pen, qreal width);
+        Pipeline &combine(const QPainterPath &path, Booleans boolOperator);
+        Pipeline &combine(const SkPath &path, Booleans boolOperator);
+        Pipeline &simplify();
+        Pipeline &offset(qreal distance);
+        Pipeline &map(const QTransform &transform);
+
+        const SkPath &path() const;
+        QPainterPath toPath() const;
+
+    private:
+        SkPath m_path;
+    };
+
+    static SkPath stroke(const SkPath &path, const QPen &pen, qreal width);
+
+private:
+    static SkPathOp skPathOp(Booleans boolOperator);
+
 };
 
 #endif // PATHHANDLER_H
@@ -0,0 +1,152 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "shapetemplate.h"
+
+#include <QtMath>
+
+// maximal number of cached polygon templates
+static const int MaxPolygonTemplates = 64;
+
+// distance of the control points of a 90° bezier arc, same as QT_PATH_KAPPA
+static const qreal Kappa = 0.5522847498;
+
+QHash<QPair<int, qreal>, QPolygonF> ShapeTemplate::m_polygons;
+
+/***************************************************
+ *
+ * Public
+ *
+ ***************************************************/
+
+/*!
+ * \brief Returns a regular polygon or star which touches the frame with its outer vertices.
+ * The first vertex is at the top center, vertices follow clockwise.
+ * \param frame
+ * \param points number of vertices
+ * \param innerRadius length of every second vertex relative to the outer radius, 1.0 for polygons
+ * \return
+ */
+QPainterPath ShapeTemplate::polygon(const QRectF &frame, int points, qreal innerRadius)
+{
+    const QPolygonF &unit = unitPolygon(points, innerRadius);
+    if(unit.isEmpty()) return QPainterPath();
+
+    const qreal x = frame.x();
+    const qreal y = frame.y();
+    const qreal w = frame.width();
+    const qreal h = frame.height();
+
+    QPainterPath path;
+    path.reserve(unit.size() + 2);
+    path.moveTo(x + unit.first().x() * w, y + unit.first().y() * h);
+
+    for(int i = 1; i < unit.size(); ++i){
+        const QPointF &point = unit.at(i);
+        path.lineTo(x + point.x() * w, y + point.y() * h);
+    }
+
+    path.closeSubpath();
+    return path;
+}
+
+
+/*!
+ * \brief Returns a rect with individual corner radii. Radii have to be clamped by the caller.
+ * Each corner is a single bezier arc built from the unit arc template, like QPainterPath::arcTo() would do for 90°.
+ * \param frame
+ * \param topLeft
+ * \param topRight
+ * \param bottomRight
+ * \param bottomLeft
+ * \return
+ */
+QPainterPath ShapeTemplate::roundedRect(const QRectF &frame, qreal topLeft, qreal topRight, qreal bottomRight, qreal bottomLeft)
+{
+    const qreal l = frame.left();
+    const qreal t = frame.top();
+    const qreal r = frame.right();
+    const qreal b = frame.bottom();
+
+    const qreal tl = qMax(topLeft, 0.0);
+    const qreal tr = qMax(topRight, 0.0);
+    const qreal br = qMax(bottomRight, 0.0);
+    const qreal bl = qMax(bottomLeft, 0.0);
+
+    QPainterPath path;
+    path.reserve(14);
+
+    // TL
+    path.moveTo(l, t + tl);
+    if(tl > 0) path.cubicTo(l, t + tl - tl * Kappa, l + tl - tl * Kappa, t, l + tl, t);
+
+    // TR
+    path.lineTo(r - tr, t);
+    if(tr > 0) path.cubicTo(r - tr + tr * Kappa, t, r, t + tr - tr * Kappa, r, t + tr);
+
+    // BR
+    path.lineTo(r, b - br);
+    if(br > 0) path.cubicTo(r, b - br + br * Kappa, r - br + br * Kappa, b, r - br, b);
+
+    // BL
+    path.lineTo(l + bl, b);
+    if(bl > 0) path.cubicTo(l + bl - bl * Kappa, b, l, b - bl + bl * Kappa, l, b - bl);
+
+    path.closeSubpath();
+    return path;
+}
+
+
+void ShapeTemplate::clear()
+{
+    m_polygons.clear();
+}
+
+/***************************************************
+ *
+ * Private
+ *
+ ***************************************************/
+
+/*!
+ * \brief Returns the vertices of a polygon in the unit square, computed once per point count and inner radius.
+ */
+const QPolygonF &ShapeTemplate::unitPolygon(int points, qreal innerRadius)
+{
+    const QPair<int, qreal> key(points, innerRadius);
+
+    QHash<QPair<int, qreal>, QPolygonF>::const_iterator it = m_polygons.constFind(key);
+    if(it != m_polygons.constEnd()) return it.value();
+
+    if(m_polygons.size() >= MaxPolygonTemplates) m_polygons.clear();
+
+    QPolygonF unit;
+    unit.reserve(points);
+
+    for(int i = 0; i < points; ++i){
+        const qreal angle = (-90.0 + 360.0 * i / points) * M_PI / 180.0;
+        const qreal length = (i % 2) ? innerRadius : 1.0;
+        unit.append(QPointF(0.5 + 0.5 * length * qCos(angle), 0.5 + 0.5 * length * qSin(angle)));
+    }
+
+    return m_polygons.insert(key, unit).value();
+}
@@ -0,0 +1,52 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef SHAPETEMPLATE_H
+#define SHAPETEMPLATE_H
+
+#include <QPainterPath>
+#include <QPolygonF>
+#include <QHash>
+#include <QPair>
+
+/*!
+ * \brief Builds item shapes from precomputed unit templates. Resizing an item only scales the template
+ * into the new frame, no trigonometry is involved. Templates are shared by all items of the GUI thread.
+ */
+class ShapeTemplate
+{
+public:
+
+    static QPainterPath polygon(const QRectF &frame, int points, qreal innerRadius = 1.0);
+    static QPainterPath roundedRect(const QRectF &frame, qreal topLeft, qreal topRight, qreal bottomRight, qreal bottomLeft);
+
+    static void clear();
+
+private:
+
+    static const QPolygonF &unitPolygon(int points, qreal innerRadius);
+
+    static QHash<QPair<int, qreal>, QPolygonF> m_polygons;
+
+};
+
+#endif // SHAPETEMPLATE_H
@@ -22,9 +22,141 @@
 
 #include "mainwindow.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include <documentio.h>
+
+/*!
+ * \brief Returns true if the command line asks for a headless export. Has to be checked before the application
+ * exists, because the platform plugin is chosen on construction.
+ */
+static bool isExportMode(int argc, char *argv[])
+{
+    for(int i = 1; i < argc; ++i){
+        const QByteArray argument(argv[i]);
+        if(argument == "--export" || argument.startsWith("--export=")) return true;
+    }
+
+    return false;
+}
+
+/*!
+ * \brief Loads a document into a scene without window and exports the items of it.
+ * Prints the timing of every item and returns a non-zero exit code if anything failed.
+ */
+static int exportDocument(const QCommandLineParser &parser)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    // file formats, either repeated or comma separated
+    QList<ExportLevel::FileFormat> formats;
+    foreach(QString value, parser.values("format")){
+        foreach(QString format, value.toLower().split(',', Qt::SkipEmptyParts)){
+            if(format == "png") formats.append(ExportLevel::PNG);
+            else if(format == "jpg" || format == "jpeg") formats.append(ExportLevel::JPG);
+            else if(format == "svg") formats.append(ExportLevel::SVG);
+            else if(format == "pdf") formats.append(ExportLevel::PDF);
+            else if(format == "atlas") formats.append(ExportLevel::Atlas);
+            else{
+                err << "Unknown export format: " << format << Qt::endl;
+                return 2;
+            }
+        }
+    }
+
+    CanvasScene scene;
+    QString errorMessage;
+
+    if(!DocumentIO::load(parser.value("export"), &scene, &errorMessage)){
+        err << "Can't load " << parser.value("export") << ": " << errorMessage << Qt::endl;
+        return 1;
+    }
+
+    const QString directory = QDir(parser.value("output")).absolutePath();
+    if(!QDir().mkpath(directory)){
+        err << "Can't create output directory " << directory << Qt::endl;
+        return 1;
+    }
+
+    const QStringList names = parser.values("item");
+    QStringList missingNames = names;
+    QList<AbstractItemBase*> items;
+
+    foreach(QGraphicsItem *item, scene.items(Qt::AscendingOrder)){
+        AbstractItemBase *aItem = dynamic_cast<AbstractItemBase*>(item);
+        if(!aItem || aItem->exportLevels().isEmpty()) continue;
+        if(!names.isEmpty() && !names.contains(aItem->name())) continue;
+
+        missingNames.removeAll(aItem->name());
+        items.append(aItem);
+    }
+
+    foreach(QString name, missingNames){
+        err << "No item with export levels named " << name << Qt::endl;
+    }
+
+    if(!missingNames.isEmpty()) return 1;
+
+    int fileCount = 0;
+    int skipCount = 0;
+    int errorCount = 0;
+
+    ExportEngine *engine = scene.exportEngine();
+    engine->setOutputDirectory(directory);
+    engine->setFileFormats(formats);
+    engine->setIncremental(!parser.isSet("force"));
+
+    QObject::connect(engine, &ExportEngine::itemExported, [&](const ExportEngine::Result &result){
+        if(result.files.isEmpty() && result.errors.isEmpty()){
+            out << QString("%1  %2 (%3 unchanged)")
+                   .arg("unchanged", 33)
+                   .arg(result.name)
+                   .arg(result.skipped.count()) << Qt::endl;
+        }else{
+            out << QString("%1 ms record %2 ms write  %3 (%4 files)")
+                   .arg(result.recordNsecs / 1e6, 9, 'f', 2)
+                   .arg(result.nsecs / 1e6, 9, 'f', 2)
+                   .arg(result.name)
+                   .arg(result.files.count()) << Qt::endl;
+        }
+
+        foreach(QString file, result.errors){
+            err << "Failed to write " << file << Qt::endl;
+        }
+
+        fileCount += result.files.count();
+        skipCount += result.skipped.count();
+        errorCount += result.errors.count();
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+
+    engine->exportItems(items);
+    engine->waitForFinished();
+
+    out << QString("%1 files written to %2 in %3 ms, %4 unchanged, %5 failed")
+           .arg(fileCount)
+           .arg(directory)
+           .arg(timer.elapsed())
+           .arg(skipCount)
+           .arg(errorCount) << Qt::endl;
+
+    return (errorCount > 0) ? 1 : 0;
+}
 
 int main(int argc, char *argv[])
 {
+    // export runs without display
+    const bool exportMode = isExportMode(argc, argv);
+    if(exportMode && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")){
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication a(argc, argv);
 
     QCoreApplication::setApplicationName("Draftoola Studio");
@@ -44,6 +176,21 @@ int main(int argc, char *argv[])
     qRegisterMetaType<Color>("Color");
 //    qRegisterMetaType<AbstractItemBase>("AbstractItemBase");
 
+    QCommandLineParser parser;
+    parser.setApplicationDescription("UI and UX prototyping tool for designing static and animated layouts.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions({
+        {"export", "Exports all export levels of <document> without opening a window.", "document"},
+        {{"o", "output"}, "Writes exported files into <directory>.", "directory", "."},
+        {"item", "Exports only items named <name>. Can be repeated.", "name"},
+        {"format", "Exports only levels of <format> (png, jpg, svg, pdf, atlas). Can be repeated.", "format"},
+        {"force", "Writes all files, even if the export manifest marks them as unchanged."}
+    });
+    parser.process(a);
+
+    if(exportMode) return exportDocument(parser);
+
     MainWindow w;
     w.show();
 
@@ -92,6 +92,7 @@ void MainWindow::setupWorkspace()
 
     m_canvas = new CanvasView();
     this->setCentralWidget(m_canvas);
+    m_scene = qobject_cast<CanvasScene*>(m_canvas->scene());
 
     m_outlinerDock = new QDockWidget(tr("Outliner"));
     m_outlinerDock->setWidget(m_outliner);
@@ -178,6 +179,14 @@ void MainWindow::connectSlots()
     connect(m_properties, &ItemProperties::exportItem, [this](AbstractItemBase *item){
         emit m_scene->exportItem(item);
     });
+
+    // background export progress
+    connect(m_scene->exportEngine(), &ExportEngine::progress, this, [this](int done, int total){
+        ui->statusBar->showMessage(tr("Exporting %1 of %2").arg(done).arg(total));
+    });
+    connect(m_scene->exportEngine(), &ExportEngine::finished, this, [this](bool canceled){
+        ui->statusBar->showMessage(canceled ? tr("Export canceled") : tr("Export finished"), 3000);
+    });
 }
 
 void MainWindow::tmpSetup(int offsetX, int offsetY)
@@ -0,0 +1,701 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "displaylist.h"
+
+#include <QPixmap>
+#include <QGraphicsItem>
+#include <QStyleOptionGraphicsItem>
+
+#include <abstractitembase.h>
+
+// Version of the serialized format, 2 added text commands
+static const quint32 DisplayListVersion = 2;
+
+/***************************************************
+ *
+ * Helper
+ *
+ ***************************************************/
+
+/*!
+ * \brief Returns brush which can be used by several threads at once. Pixmap textures are converted lazily
+ * by QBrush, so they are replaced by image textures while recording.
+ */
+static QBrush threadSafeBrush(const QBrush &brush)
+{
+    if(brush.style() != Qt::TexturePattern) return brush;
+
+    QBrush imageBrush(brush.textureImage());
+    imageBrush.setTransform(brush.transform());
+    return imageBrush;
+}
+
+/*!
+ * \brief Returns pen which can be used by several threads at once. The dash pattern is calculated lazily by QPen.
+ */
+static QPen threadSafePen(const QPen &pen)
+{
+    QPen safePen(pen);
+    safePen.setBrush(threadSafeBrush(pen.brush()));
+    safePen.dashPattern();
+    return safePen;
+}
+
+/*!
+ * \brief Returns a copy with its own path data. Paint engines cache converted paths in the shared data,
+ * so a path must not be drawn by two threads at the same time.
+ */
+static QPainterPath detachedPath(const QPainterPath &path)
+{
+    QPainterPath copy;
+    copy.setFillRule(path.fillRule());
+    copy.addPath(path);
+    return copy;
+}
+
+/*!
+ * \brief Writes raw image pixels. Unlike the QImage stream operator it doesn't encode a PNG.
+ */
+static void writeImage(QDataStream &out, const QImage &image)
+{
+    out << int(image.format()) << image.width() << image.height() << image.bytesPerLine();
+
+    for(int y = 0; y < image.height(); ++y){
+        out.writeRawData(reinterpret_cast<const char*>(image.constScanLine(y)), image.bytesPerLine());
+    }
+}
+
+static QImage readImage(QDataStream &in)
+{
+    int format = 0, width = 0, height = 0, bytesPerLine = 0;
+    in >> format >> width >> height >> bytesPerLine;
+
+    if(in.status() != QDataStream::Ok || width <= 0 || height <= 0) return QImage();
+
+    QImage image(width, height, QImage::Format(format));
+    if(image.isNull() || image.bytesPerLine() != bytesPerLine){
+        in.setStatus(QDataStream::ReadCorruptData);
+        return QImage();
+    }
+
+    for(int y = 0; y < height; ++y){
+        in.readRawData(reinterpret_cast<char*>(image.scanLine(y)), bytesPerLine);
+    }
+
+    return image;
+}
+
+/*!
+ * \brief Restores the clip the target painter had before the replay started.
+ */
+static void resetClip(QPainter *painter, bool baseClipping, const QPainterPath &baseClip)
+{
+    if(!baseClipping){
+        painter->setClipping(false);
+        return;
+    }
+
+    QTransform transform = painter->transform();
+    painter->resetTransform();
+    painter->setClipPath(baseClip, Qt::ReplaceClip);
+    painter->setTransform(transform);
+}
+
+
+/***************************************************
+ *
+ * Paint Engine
+ *
+ ***************************************************/
+
+class DisplayListEngine : public QPaintEngine
+{
+public:
+
+    DisplayListEngine() : QPaintEngine(QPaintEngine::AllFeatures), m_data(new DisplayList::Data()) {}
+
+    bool begin(QPaintDevice *pdev) override
+    {
+        m_dpi = pdev->logicalDpiY();
+        m_transform = QTransform();
+        m_pen = QPen();
+        return true;
+    }
+
+    bool end() override
+    {
+        return true;
+    }
+
+    Type type() const override
+    {
+        return QPaintEngine::User;
+    }
+
+    void updateState(const QPaintEngineState &state) override
+    {
+        DisplayList::Command command;
+        command.type = DisplayList::CommandType::State;
+        command.dirty = state.state();
+
+        if(command.dirty & DirtyTransform){
+            command.transform = state.transform();
+            command.transform.type(); // cache matrix type before sharing it
+            m_transform = command.transform;
+        }
+        if(command.dirty & DirtyPen){
+            command.pen = threadSafePen(state.pen());
+            m_pen = command.pen;
+        }
+        if(command.dirty & DirtyBrush) command.brush = threadSafeBrush(state.brush());
+        if(command.dirty & DirtyBrushOrigin) command.brushOrigin = state.brushOrigin();
+        if(command.dirty & DirtyBackground) command.background = threadSafeBrush(state.backgroundBrush());
+        if(command.dirty & DirtyBackgroundMode) command.backgroundMode = state.backgroundMode();
+        if(command.dirty & DirtyHints) command.hints = state.renderHints();
+        if(command.dirty & DirtyCompositionMode) command.compositionMode = state.compositionMode();
+        if(command.dirty & DirtyOpacity) command.opacity = state.opacity();
+        if(command.dirty & DirtyClipEnabled) command.clipEnabled = state.isClipEnabled();
+        if(command.dirty & DirtyClipPath){
+            command.clipPath = state.clipPath();
+            command.clipOperation = state.clipOperation();
+        }
+        if(command.dirty & DirtyClipRegion){
+            command.clipRegion = state.clipRegion();
+            command.clipOperation = state.clipOperation();
+        }
+
+        m_data->commands.append(command);
+    }
+
+    void drawPath(const QPainterPath &path) override
+    {
+        DisplayList::Command command;
+        command.type = DisplayList::CommandType::Path;
+        command.path = path;
+        m_data->commands.append(command);
+
+        addBounds(path.controlPointRect(), true);
+    }
+
+    void drawPolygon(const QPointF *points, int pointCount, PolygonDrawMode mode) override
+    {
+        DisplayList::Command command;
+        command.type = DisplayList::CommandType::Polygon;
+        command.polygon.reserve(pointCount);
+        for(int i = 0; i < pointCount; ++i){
+            command.polygon.append(points[i]);
+        }
+        command.polygonMode = mode;
+        m_data->commands.append(command);
+
+        addBounds(command.polygon.boundingRect(), true);
+    }
+
+    void drawPixmap(const QRectF &r, const QPixmap &pm, const QRectF &sr) override
+    {
+        drawImage(r, pm.toImage(), sr, Qt::AutoColor);
+    }
+
+    void drawImage(const QRectF &r, const QImage &pm, const QRectF &sr, Qt::ImageConversionFlags flags) override
+    {
+        DisplayList::Command command;
+        command.type = DisplayList::CommandType::Image;
+        command.rect = r;
+        command.image = pm;
+        command.sourceRect = sr;
+        command.imageFlags = flags;
+        m_data->commands.append(command);
+
+        addBounds(r, false);
+    }
+
+    void drawTiledPixmap(const QRectF &r, const QPixmap &pixmap, const QPointF &s) override
+    {
+        DisplayList::Command command;
+        command.type = DisplayList::CommandType::TiledImage;
+        command.rect = r;
+        command.image = pixmap.toImage();
+        command.point = s;
+        m_data->commands.append(command);
+
+        addBounds(r, false);
+    }
+
+    /*!
+     * \brief Records text as text instead of glyph outlines, so vector outputs keep real text.
+     * The font size is stored in pixels because the replay device may use another resolution.
+     */
+    void drawTextItem(const QPointF &p, const QTextItem &textItem) override
+    {
+        const QFont font = textItem.font();
+
+        DisplayList::Command command;
+        command.type = DisplayList::CommandType::Text;
+        command.point = p;
+        command.text = textItem.text();
+        command.font = font;
+        command.fontPixelSize = (font.pixelSize() > 0) ? font.pixelSize() : font.pointSizeF() * m_dpi / 72.0;
+        command.rightToLeft = textItem.renderFlags().testFlag(QTextItem::RightToLeft);
+        m_data->commands.append(command);
+
+        addBounds(QRectF(p.x(), p.y() - textItem.ascent(), textItem.width(), textItem.ascent() + textItem.descent()), false);
+    }
+
+    DisplayList displayList() const
+    {
+        DisplayList list;
+        list.d = QSharedPointer<const DisplayList::Data>(new DisplayList::Data(*m_data));
+        return list;
+    }
+
+    void clear()
+    {
+        m_data.reset(new DisplayList::Data());
+    }
+
+private:
+
+    QSharedPointer<DisplayList::Data> m_data;
+    QTransform m_transform;
+    QPen m_pen;
+    int m_dpi = 96;
+
+    void addBounds(const QRectF &rect, bool stroked)
+    {
+        QRectF bounds = m_transform.mapRect(rect);
+
+        if(stroked && m_pen.style() != Qt::NoPen){
+            qreal width = qMax(1.0, m_pen.widthF());
+            if(!m_pen.isCosmetic()) width *= qMax(qAbs(m_transform.m11()) + qAbs(m_transform.m21()),
+                                                   qAbs(m_transform.m12()) + qAbs(m_transform.m22()));
+            bounds.adjust(-width, -width, width, width);
+        }
+
+        m_data->boundingRect = m_data->boundingRect.united(bounds);
+    }
+
+};
+
+
+/***************************************************
+ *
+ * Display List
+ *
+ ***************************************************/
+
+DisplayList::DisplayList() {}
+
+
+/*!
+ * \brief Replays all recorded commands on the painter. Recorded transformations and clips are applied
+ * relative to the current state of the painter. The painter state is restored afterwards.
+ * \param painter
+ */
+void DisplayList::replay(QPainter *painter) const
+{
+    if(isEmpty()) return;
+
+    painter->save();
+
+    const QTransform base = painter->transform();
+    const qreal baseOpacity = painter->opacity();
+    const bool baseClipping = painter->hasClipping();
+    const QPainterPath baseClip = (baseClipping) ? base.map(painter->clipPath()) : QPainterPath();
+
+    // start with the default state of a new painter
+    painter->setPen(QPen());
+    painter->setBrush(QBrush());
+    painter->setBrushOrigin(QPointF());
+    painter->setBackground(QBrush(Qt::white));
+    painter->setBackgroundMode(Qt::TransparentMode);
+    painter->setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter->setRenderHints(painter->renderHints(), false);
+
+    for(const Command &command : d->commands){
+
+        switch(command.type){
+        case CommandType::State:{
+            QPaintEngine::DirtyFlags dirty = command.dirty;
+
+            if(dirty & QPaintEngine::DirtyTransform) painter->setTransform(command.transform * base);
+            if(dirty & QPaintEngine::DirtyPen) painter->setPen(command.pen);
+            if(dirty & QPaintEngine::DirtyBrush) painter->setBrush(command.brush);
+            if(dirty & QPaintEngine::DirtyBrushOrigin) painter->setBrushOrigin(command.brushOrigin);
+            if(dirty & QPaintEngine::DirtyBackground) painter->setBackground(command.background);
+            if(dirty & QPaintEngine::DirtyBackgroundMode) painter->setBackgroundMode(command.backgroundMode);
+            if(dirty & QPaintEngine::DirtyHints){
+                painter->setRenderHints(painter->renderHints(), false);
+                painter->setRenderHints(command.hints, true);
+            }
+            if(dirty & QPaintEngine::DirtyCompositionMode) painter->setCompositionMode(command.compositionMode);
+            if(dirty & QPaintEngine::DirtyOpacity) painter->setOpacity(baseOpacity * command.opacity);
+            if((dirty & QPaintEngine::DirtyClipEnabled) && !command.clipEnabled){
+                resetClip(painter, baseClipping, baseClip);
+            }
+            if(dirty & (QPaintEngine::DirtyClipPath | QPaintEngine::DirtyClipRegion)){
+                Qt::ClipOperation operation = command.clipOperation;
+
+                if(operation == Qt::NoClip || operation == Qt::ReplaceClip){
+                    resetClip(painter, baseClipping, baseClip);
+                    operation = (baseClipping) ? Qt::IntersectClip : Qt::ReplaceClip;
+                }
+
+                if(command.clipOperation != Qt::NoClip){
+                    if(dirty & QPaintEngine::DirtyClipPath) painter->setClipPath(detachedPath(command.clipPath), operation);
+                    else painter->setClipRegion(command.clipRegion, operation);
+                }
+            }
+            break;
+        }
+        case CommandType::Path:
+            painter->drawPath(detachedPath(command.path));
+            break;
+        case CommandType::Polygon:
+            if(command.polygonMode == QPaintEngine::PolylineMode){
+                painter->drawPolyline(command.polygon);
+            }else{
+                painter->drawPolygon(command.polygon, (command.polygonMode == QPaintEngine::WindingMode) ? Qt::WindingFill : Qt::OddEvenFill);
+            }
+            break;
+        case CommandType::Image:
+            painter->drawImage(command.rect, command.image, command.sourceRect, command.imageFlags);
+            break;
+        case CommandType::TiledImage:{
+            // brush based tiling avoids creating pixmaps outside of the gui thread
+            QBrush brush(command.image);
+            QPointF origin = painter->brushOrigin();
+            painter->setBrushOrigin(command.rect.topLeft() - command.point);
+            painter->fillRect(command.rect, brush);
+            painter->setBrushOrigin(origin);
+            break;
+        }
+        case CommandType::Text:{
+            QFont font = command.font;
+            font.setPointSizeF(command.fontPixelSize * 72.0 / painter->device()->logicalDpiY());
+
+            const Qt::LayoutDirection direction = painter->layoutDirection();
+            painter->setFont(font);
+            painter->setLayoutDirection(command.rightToLeft ? Qt::RightToLeft : Qt::LeftToRight);
+            painter->drawText(command.point, command.text);
+            painter->setLayoutDirection(direction);
+            break;
+        }
+        }
+    }
+
+    painter->restore();
+}
+
+
+bool DisplayList::isEmpty() const
+{
+    return d.isNull() || d->commands.isEmpty();
+}
+
+
+int DisplayList::size() const
+{
+    return (d.isNull()) ? 0 : d->commands.size();
+}
+
+
+/*!
+ * \brief Returns the area covered by recorded draw commands in device coordinates of the recording painter.
+ * \return
+ */
+QRectF DisplayList::boundingRect() const
+{
+    return (d.isNull()) ? QRectF() : d->boundingRect;
+}
+
+
+/***************************************************
+ *
+ * Serialization
+ *
+ ***************************************************/
+
+/*!
+ * \brief Writes all commands, so a display list can be replayed by a headless renderer.
+ */
+QDataStream &operator<<(QDataStream &out, const DisplayList &list)
+{
+    out << DisplayListVersion
+        << list.size()
+        << list.boundingRect();
+
+    if(list.isEmpty()) return out;
+
+    for(const DisplayList::Command &command : list.d->commands){
+
+        out << int(command.type);
+
+        switch(command.type){
+        case DisplayList::CommandType::State:{
+            QPaintEngine::DirtyFlags dirty = command.dirty;
+            out << int(dirty);
+
+            if(dirty & QPaintEngine::DirtyTransform) out << command.transform;
+            if(dirty & QPaintEngine::DirtyPen) out << command.pen;
+            if(dirty & QPaintEngine::DirtyBrush) out << command.brush;
+            if(dirty & QPaintEngine::DirtyBrushOrigin) out << command.brushOrigin;
+            if(dirty & QPaintEngine::DirtyBackground) out << command.background;
+            if(dirty & QPaintEngine::DirtyBackgroundMode) out << int(command.backgroundMode);
+            if(dirty & QPaintEngine::DirtyHints) out << int(command.hints);
+            if(dirty & QPaintEngine::DirtyCompositionMode) out << int(command.compositionMode);
+            if(dirty & QPaintEngine::DirtyOpacity) out << (double)command.opacity;
+            if(dirty & QPaintEngine::DirtyClipEnabled) out << command.clipEnabled;
+            if(dirty & QPaintEngine::DirtyClipPath) out << int(command.clipOperation) << command.clipPath;
+            if(dirty & QPaintEngine::DirtyClipRegion) out << int(command.clipOperation) << command.clipRegion;
+            break;
+        }
+        case DisplayList::CommandType::Path:
+            out << command.path;
+            break;
+        case DisplayList::CommandType::Polygon:
+            out << int(command.polygonMode) << command.polygon;
+            break;
+        case DisplayList::CommandType::Image:
+            out << command.rect << command.sourceRect << int(command.imageFlags);
+            writeImage(out, command.image);
+            break;
+        case DisplayList::CommandType::TiledImage:
+            out << command.rect << command.point;
+            writeImage(out, command.image);
+            break;
+        case DisplayList::CommandType::Text:
+            out << command.point << command.text << command.font << (double)command.fontPixelSize << command.rightToLeft;
+            break;
+        }
+    }
+
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, DisplayList &list)
+{
+    list = DisplayList();
+
+    quint32 version = 0;
+    int count = 0;
+    QSharedPointer<DisplayList::Data> data(new DisplayList::Data());
+
+    in >> version >> count >> data->boundingRect;
+
+    // older versions are a subset of the current format
+    if(version == 0 || version > DisplayListVersion || count < 0){
+        in.setStatus(QDataStream::ReadCorruptData);
+        return in;
+    }
+
+    data->commands.reserve(count);
+
+    int value = 0;
+    double number = 0;
+
+    for(int i = 0; i < count && in.status() == QDataStream::Ok; ++i){
+
+        DisplayList::Command command;
+        in >> value;
+        command.type = DisplayList::CommandType(value);
+
+        switch(command.type){
+        case DisplayList::CommandType::State:{
+            in >> value;
+            QPaintEngine::DirtyFlags dirty = QPaintEngine::DirtyFlags(value);
+            command.dirty = dirty;
+
+            if(dirty & QPaintEngine::DirtyTransform){
+                in >> command.transform;
+                command.transform.type();
+            }
+            if(dirty & QPaintEngine::DirtyPen){
+                in >> command.pen;
+                command.pen.dashPattern();
+            }
+            if(dirty & QPaintEngine::DirtyBrush) in >> command.brush;
+            if(dirty & QPaintEngine::DirtyBrushOrigin) in >> command.brushOrigin;
+            if(dirty & QPaintEngine::DirtyBackground) in >> command.background;
+            if(dirty & QPaintEngine::DirtyBackgroundMode){
+                in >> value;
+                command.backgroundMode = Qt::BGMode(value);
+            }
+            if(dirty & QPaintEngine::DirtyHints){
+                in >> value;
+                command.hints = QPainter::RenderHints(value);
+            }
+            if(dirty & QPaintEngine::DirtyCompositionMode){
+                in >> value;
+                command.compositionMode = QPainter::CompositionMode(value);
+            }
+            if(dirty & QPaintEngine::DirtyOpacity){
+                in >> number;
+                command.opacity = number;
+            }
+            if(dirty & QPaintEngine::DirtyClipEnabled) in >> command.clipEnabled;
+            if(dirty & QPaintEngine::DirtyClipPath){
+                in >> value >> command.clipPath;
+                command.clipOperation = Qt::ClipOperation(value);
+            }
+            if(dirty & QPaintEngine::DirtyClipRegion){
+                in >> value >> command.clipRegion;
+                command.clipOperation = Qt::ClipOperation(value);
+            }
+            break;
+        }
+        case DisplayList::CommandType::Path:
+            in >> command.path;
+            break;
+        case DisplayList::CommandType::Polygon:
+            in >> value >> command.polygon;
+            command.polygonMode = QPaintEngine::PolygonDrawMode(value);
+            break;
+        case DisplayList::CommandType::Image:
+            in >> command.rect >> command.sourceRect >> value;
+            command.imageFlags = Qt::ImageConversionFlags(value);
+            command.image = readImage(in);
+            break;
+        case DisplayList::CommandType::TiledImage:
+            in >> command.rect >> command.point;
+            command.image = readImage(in);
+            break;
+        case DisplayList::CommandType::Text:
+            in >> command.point >> command.text >> command.font >> number >> command.rightToLeft;
+            command.fontPixelSize = number;
+            break;
+        default:
+            in.setStatus(QDataStream::ReadCorruptData);
+            break;
+        }
+
+        data->commands.append(command);
+    }
+
+    if(in.status() == QDataStream::Ok) list.d = data;
+
+    return in;
+}
+
+
+/***************************************************
+ *
+ * Recorder
+ *
+ ***************************************************/
+
+DisplayListRecorder::DisplayListRecorder(int dpi) : QPaintDevice()
+{
+    m_engine = new DisplayListEngine();
+    m_dpi = dpi;
+}
+
+DisplayListRecorder::~DisplayListRecorder()
+{
+    delete m_engine;
+}
+
+QPaintEngine *DisplayListRecorder::paintEngine() const
+{
+    return m_engine;
+}
+
+
+/*!
+ * \brief Returns the commands recorded so far. Later recordings don't modify the returned list.
+ * \return
+ */
+DisplayList DisplayListRecorder::displayList() const
+{
+    return m_engine->displayList();
+}
+
+void DisplayListRecorder::clear()
+{
+    m_engine->clear();
+}
+
+
+/*!
+ * \brief Records item and its children with their scene transform followed by view. Only document items are
+ * painted, other items like labels and artboard canvases just pass their clip on to their children.
+ * \param painter
+ * \param item
+ * \param view maps scene coordinates to the recording
+ */
+void DisplayListRecorder::recordItem(QPainter *painter, QGraphicsItem *item, const QTransform &view)
+{
+    if(!item->isVisible()) return;
+
+    const QTransform transform = item->sceneTransform() * view;
+
+    painter->save();
+    painter->setTransform(transform);
+
+    if(dynamic_cast<AbstractItemBase*>(item)){
+        QStyleOptionGraphicsItem option;
+        option.exposedRect = item->boundingRect();
+        option.rect = option.exposedRect.toRect();
+        item->paint(painter, &option, nullptr);
+        painter->setTransform(transform);
+    }
+
+    if(item->flags() & QGraphicsItem::ItemClipsChildrenToShape){
+        painter->setClipPath(item->shape(), Qt::IntersectClip);
+    }
+
+    foreach(QGraphicsItem *child, item->childItems()){
+        recordItem(painter, child, view);
+    }
+
+    painter->restore();
+}
+
+int DisplayListRecorder::metric(PaintDeviceMetric metric) const
+{
+    // recorded commands are unbounded, use a large virtual canvas
+    const int size = 1 << 24;
+
+    switch(metric){
+    case PdmWidth:
+    case PdmHeight:
+        return size;
+    case PdmWidthMM:
+    case PdmHeightMM:
+        return qRound(size * 25.4 / m_dpi);
+    case PdmNumColors:
+        return INT_MAX;
+    case PdmDepth:
+        return 32;
+    case PdmDpiX:
+    case PdmDpiY:
+    case PdmPhysicalDpiX:
+    case PdmPhysicalDpiY:
+        return m_dpi;
+    case PdmDevicePixelRatio:
+        return 1;
+    case PdmDevicePixelRatioScaled:
+        return static_cast<int>(QPaintDevice::devicePixelRatioFScale());
+    default:
+        return QPaintDevice::metric(metric);
+    }
+}
@@ -0,0 +1,149 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef DISPLAYLIST_H
+#define DISPLAYLIST_H
+
+#include <QPaintDevice>
+#include <QPaintEngine>
+#include <QPainter>
+#include <QSharedPointer>
+#include <QPainterPath>
+#include <QPolygonF>
+#include <QFont>
+#include <QImage>
+#include <QPen>
+#include <QBrush>
+#include <QRegion>
+#include <QTransform>
+#include <QVector>
+#include <QDataStream>
+
+class DisplayListEngine;
+class QGraphicsItem;
+
+/*!
+ * \brief Immutable list of recorded paint commands. Copies share the recorded data, so a
+ * display list can be handed to worker threads and replayed there concurrently.
+ */
+class DisplayList
+{
+public:
+
+    DisplayList();
+
+    void replay(QPainter *painter) const;
+
+    bool isEmpty() const;
+    int size() const;
+    QRectF boundingRect() const;
+
+    friend QDataStream &operator<<(QDataStream &out, const DisplayList &list);
+    friend QDataStream &operator>>(QDataStream &in, DisplayList &list);
+
+private:
+
+    friend class DisplayListRecorder;
+    friend class DisplayListEngine;
+
+    enum class CommandType {
+        State = 0,
+        Path = 1,
+        Polygon = 2,
+        Image = 3,
+        TiledImage = 4,
+        Text = 5
+    };
+
+    struct Command {
+        CommandType type = CommandType::State;
+
+        // draw commands
+        QPainterPath path;
+        QPolygonF polygon;
+        QPaintEngine::PolygonDrawMode polygonMode = QPaintEngine::OddEvenMode;
+        QImage image;
+        QRectF rect;
+        QRectF sourceRect;
+        QPointF point;
+        Qt::ImageConversionFlags imageFlags = Qt::AutoColor;
+        QString text;
+        QFont font;
+        qreal fontPixelSize = 0;
+        bool rightToLeft = false;
+
+        // state commands
+        QPaintEngine::DirtyFlags dirty;
+        QTransform transform;
+        QPen pen;
+        QBrush brush;
+        QPointF brushOrigin;
+        QBrush background;
+        Qt::BGMode backgroundMode = Qt::TransparentMode;
+        QPainter::RenderHints hints;
+        QPainter::CompositionMode compositionMode = QPainter::CompositionMode_SourceOver;
+        qreal opacity = 1;
+        bool clipEnabled = false;
+        Qt::ClipOperation clipOperation = Qt::NoClip;
+        QPainterPath clipPath;
+        QRegion clipRegion;
+    };
+
+    struct Data {
+        QVector<Command> commands;
+        QRectF boundingRect;
+    };
+
+    QSharedPointer<const Data> d;
+
+};
+
+
+/*!
+ * \brief Paint device which records all paint commands into a DisplayList.
+ */
+class DisplayListRecorder : public QPaintDevice
+{
+public:
+
+    DisplayListRecorder(int dpi = 96);
+    ~DisplayListRecorder() override;
+
+    QPaintEngine *paintEngine() const override;
+
+    DisplayList displayList() const;
+    void clear();
+
+    static void recordItem(QPainter *painter, QGraphicsItem *item, const QTransform &view);
+
+protected:
+
+    int metric(PaintDeviceMetric metric) const override;
+
+private:
+
+    DisplayListEngine *m_engine;
+    int m_dpi;
+
+};
+
+#endif // DISPLAYLIST_H
@@ -0,0 +1,434 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "imagestreamwriter.h"
+
+#ifdef DRAFTOOLA_STREAM_ENCODER
+
+#include <csetjmp>
+#include <cstdio>
+
+#include <png.h>
+#include <jpeglib.h>
+#include <jerror.h>
+
+// size of the buffer libjpeg writes into before it gets flushed to the file
+static const int JpegBufferSize = 64 * 1024;
+
+struct JpegError {
+    jpeg_error_mgr manager;
+    jmp_buf jump;
+};
+
+struct JpegDestination {
+    jpeg_destination_mgr manager;
+    QFile *file;
+    JOCTET buffer[JpegBufferSize];
+};
+
+struct StreamEncoder {
+    png_structp png = nullptr;
+    png_infop pngInfo = nullptr;
+
+    bool hasJpeg = false;
+    jpeg_compress_struct jpeg;
+    JpegError jpegError;
+    JpegDestination jpegDestination;
+};
+
+/***************************************************
+ *
+ * libpng
+ *
+ ***************************************************/
+
+// The functions calling setjmp() must not own objects with destructors, longjmp() would skip them.
+
+static void pngWrite(png_structp png, png_bytep data, png_size_t length)
+{
+    QFile *file = static_cast<QFile*>(png_get_io_ptr(png));
+    if(file->write(reinterpret_cast<const char*>(data), static_cast<qint64>(length)) != static_cast<qint64>(length)){
+        png_error(png, "write failed");
+    }
+}
+
+static void pngFlush(png_structp png)
+{
+    static_cast<QFile*>(png_get_io_ptr(png))->flush();
+}
+
+static bool pngBegin(png_structp png, png_infop info, QFile *file, const QSize &size)
+{
+    if(setjmp(png_jmpbuf(png))) return false;
+
+    png_set_write_fn(png, file, pngWrite, pngFlush);
+    png_set_IHDR(png, info, static_cast<png_uint_32>(size.width()), static_cast<png_uint_32>(size.height()), 8,
+                 PNG_COLOR_TYPE_RGB_ALPHA, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(png, info);
+
+    return true;
+}
+
+static bool pngWriteRows(png_structp png, const QImage &rows, int rowCount)
+{
+    if(setjmp(png_jmpbuf(png))) return false;
+
+    for(int y = 0; y < rowCount; ++y){
+        png_write_row(png, rows.constScanLine(y));
+    }
+
+    return true;
+}
+
+static bool pngEnd(png_structp png, png_infop info)
+{
+    if(setjmp(png_jmpbuf(png))) return false;
+
+    png_write_end(png, info);
+
+    return true;
+}
+
+/***************************************************
+ *
+ * libjpeg
+ *
+ ***************************************************/
+
+static void jpegErrorExit(j_common_ptr cinfo)
+{
+    longjmp(reinterpret_cast<JpegError*>(cinfo->err)->jump, 1);
+}
+
+static void jpegInitDestination(j_compress_ptr cinfo)
+{
+    JpegDestination *destination = reinterpret_cast<JpegDestination*>(cinfo->dest);
+    destination->manager.next_output_byte = destination->buffer;
+    destination->manager.free_in_buffer = JpegBufferSize;
+}
+
+static boolean jpegEmptyBuffer(j_compress_ptr cinfo)
+{
+    JpegDestination *destination = reinterpret_cast<JpegDestination*>(cinfo->dest);
+
+    if(destination->file->write(reinterpret_cast<const char*>(destination->buffer), JpegBufferSize) != JpegBufferSize){
+        ERREXIT(cinfo, JERR_FILE_WRITE);
+    }
+
+    jpegInitDestination(cinfo);
+
+    return TRUE;
+}
+
+static void jpegTermDestination(j_compress_ptr cinfo)
+{
+    JpegDestination *destination = reinterpret_cast<JpegDestination*>(cinfo->dest);
+    const qint64 length = JpegBufferSize - static_cast<qint64>(destination->manager.free_in_buffer);
+
+    if(destination->file->write(reinterpret_cast<const char*>(destination->buffer), length) != length){
+        ERREXIT(cinfo, JERR_FILE_WRITE);
+    }
+}
+
+static bool jpegBegin(StreamEncoder *encoder, QFile *file, const QSize &size, int quality)
+{
+    jpeg_compress_struct *jpeg = &encoder->jpeg;
+
+    jpeg->err = jpeg_std_error(&encoder->jpegError.manager);
+    encoder->jpegError.manager.error_exit = jpegErrorExit;
+
+    if(setjmp(encoder->jpegError.jump)) return false;
+
+    jpeg_create_compress(jpeg);
+    encoder->hasJpeg = true;
+
+    encoder->jpegDestination.file = file;
+    encoder->jpegDestination.manager.init_destination = jpegInitDestination;
+    encoder->jpegDestination.manager.empty_output_buffer = jpegEmptyBuffer;
+    encoder->jpegDestination.manager.term_destination = jpegTermDestination;
+    jpeg->dest = &encoder->jpegDestination.manager;
+
+    jpeg->image_width = static_cast<JDIMENSION>(size.width());
+    jpeg->image_height = static_cast<JDIMENSION>(size.height());
+    jpeg->input_components = 3;
+    jpeg->in_color_space = JCS_RGB;
+
+    jpeg_set_defaults(jpeg);
+    jpeg_set_quality(jpeg, quality, TRUE);
+    jpeg_start_compress(jpeg, TRUE);
+
+    return true;
+}
+
+static bool jpegWriteRows(StreamEncoder *encoder, const QImage &rows, int rowCount)
+{
+    if(setjmp(encoder->jpegError.jump)) return false;
+
+    for(int y = 0; y < rowCount; ++y){
+        JSAMPROW row = const_cast<JSAMPROW>(rows.constScanLine(y));
+        jpeg_write_scanlines(&encoder->jpeg, &row, 1);
+    }
+
+    return true;
+}
+
+static bool jpegEnd(StreamEncoder *encoder)
+{
+    if(setjmp(encoder->jpegError.jump)) return false;
+
+    jpeg_finish_compress(&encoder->jpeg);
+
+    return true;
+}
+
+#else
+
+struct StreamEncoder {};
+
+#endif
+
+/***************************************************
+ *
+ * Constructor
+ *
+ ***************************************************/
+
+ImageStreamWriter::ImageStreamWriter()
+{
+    m_format = PNG;
+    m_rowsWritten = 0;
+    m_encoder = nullptr;
+}
+
+ImageStreamWriter::~ImageStreamWriter()
+{
+    if(m_encoder) abort("image is incomplete");
+}
+
+/***************************************************
+ *
+ * Properties
+ *
+ ***************************************************/
+
+/*!
+ * \brief Returns true if the application was built with libpng and libjpeg.
+ * \return
+ */
+bool ImageStreamWriter::isSupported()
+{
+#ifdef DRAFTOOLA_STREAM_ENCODER
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+int ImageStreamWriter::rowsWritten() const
+{
+    return m_rowsWritten;
+}
+
+
+QString ImageStreamWriter::errorString() const
+{
+    return m_errorString;
+}
+
+/***************************************************
+ *
+ * Members
+ *
+ ***************************************************/
+
+/*!
+ * \brief Creates the file and writes the image header.
+ * \param fileName
+ * \param size size of the whole image
+ * \param format
+ * \param quality JPG quality from 0 to 100
+ * \return
+ */
+bool ImageStreamWriter::open(const QString &fileName, const QSize &size, Format format, int quality)
+{
+    if(m_encoder) abort(QString());
+
+    m_size = size;
+    m_format = format;
+    m_rowsWritten = 0;
+    m_errorString.clear();
+
+#ifdef DRAFTOOLA_STREAM_ENCODER
+
+    if(size.isEmpty()){
+        m_errorString = "empty image";
+        return false;
+    }
+
+    m_file.setFileName(fileName);
+    if(!m_file.open(QIODevice::WriteOnly)){
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    m_encoder = new StreamEncoder();
+
+    bool started = false;
+
+    switch(format){
+    case PNG:
+        m_encoder->png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+        if(m_encoder->png) m_encoder->pngInfo = png_create_info_struct(m_encoder->png);
+        started = m_encoder->pngInfo && pngBegin(m_encoder->png, m_encoder->pngInfo, &m_file, size);
+        break;
+    case JPG:
+        started = jpegBegin(m_encoder, &m_file, size, qBound(0, quality, 100));
+        break;
+    }
+
+    if(!started){
+        abort("can't write image header");
+        return false;
+    }
+
+    return true;
+
+#else
+
+    Q_UNUSED(fileName)
+    Q_UNUSED(quality)
+
+    m_errorString = "built without streaming encoder";
+    return false;
+
+#endif
+}
+
+/*!
+ * \brief Encodes the first rows of a band. The band has to be as wide as the image,
+ * any format is accepted and converted band by band.
+ * \param band
+ * \param rowCount number of rows of the band that belong to the image
+ * \return
+ */
+bool ImageStreamWriter::writeRows(const QImage &band, int rowCount)
+{
+    if(!m_encoder) return false;
+
+    if(band.width() != m_size.width() || rowCount > band.height() || m_rowsWritten + rowCount > m_size.height()){
+        abort("band doesn't fit into the image");
+        return false;
+    }
+
+#ifdef DRAFTOOLA_STREAM_ENCODER
+
+    // PNG stores straight alpha, JPG has no alpha
+    const QImage rows = band.convertToFormat((m_format == PNG) ? QImage::Format_RGBA8888 : QImage::Format_RGB888);
+
+    const bool written = (m_format == PNG)
+            ? pngWriteRows(m_encoder->png, rows, rowCount)
+            : jpegWriteRows(m_encoder, rows, rowCount);
+
+    if(!written){
+        abort("can't encode image rows");
+        return false;
+    }
+
+    m_rowsWritten += rowCount;
+
+    return true;
+
+#else
+
+    return false;
+
+#endif
+}
+
+/*!
+ * \brief Finishes the file. Fails if not all rows of the image were written.
+ * \return
+ */
+bool ImageStreamWriter::close()
+{
+    if(!m_encoder) return false;
+
+    if(m_rowsWritten != m_size.height()){
+        abort("image is incomplete");
+        return false;
+    }
+
+#ifdef DRAFTOOLA_STREAM_ENCODER
+
+    bool finished = (m_format == PNG)
+            ? pngEnd(m_encoder->png, m_encoder->pngInfo)
+            : jpegEnd(m_encoder);
+
+    if(!finished){
+        abort("can't finish image");
+        return false;
+    }
+
+    abort(QString());
+
+    m_file.close();
+    if(m_file.error() != QFileDevice::NoError){
+        m_errorString = m_file.errorString();
+        m_file.remove();
+        return false;
+    }
+
+    return true;
+
+#else
+
+    return false;
+
+#endif
+}
+
+/***************************************************
+ *
+ * Private
+ *
+ ***************************************************/
+
+/*!
+ * \brief Releases the encoder. An error removes the incomplete file.
+ */
+void ImageStreamWriter::abort(const QString &error)
+{
+#ifdef DRAFTOOLA_STREAM_ENCODER
+    if(m_encoder->png) png_destroy_write_struct(&m_encoder->png, &m_encoder->pngInfo);
+    if(m_encoder->hasJpeg) jpeg_destroy_compress(&m_encoder->jpeg);
+#endif
+
+    delete m_encoder;
+    m_encoder = nullptr;
+
+    if(!error.isEmpty()){
+        m_errorString = error;
+        m_file.close();
+        m_file.remove();
+    }
+}
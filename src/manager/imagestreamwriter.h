@@ -0,0 +1,70 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef IMAGESTREAMWRITER_H
+#define IMAGESTREAMWRITER_H
+
+#include <QFile>
+#include <QImage>
+#include <QString>
+
+struct StreamEncoder;
+
+/*!
+ * \brief Encodes PNG and JPG files row by row through the libpng and libjpeg row APIs, so an image can be
+ * written in bands without ever holding all of its pixels. Only available if built with DRAFTOOLA_STREAM_ENCODER.
+ */
+class ImageStreamWriter
+{
+public:
+
+    enum Format {
+        PNG = 0,
+        JPG = 1
+    };
+
+    ImageStreamWriter();
+    ~ImageStreamWriter();
+
+    static bool isSupported();
+
+    bool open(const QString &fileName, const QSize &size, Format format, int quality = 100);
+    bool writeRows(const QImage &band, int rowCount);
+    bool close();
+
+    int rowsWritten() const;
+    QString errorString() const;
+
+private:
+
+    QFile m_file;
+    QSize m_size;
+    Format m_format;
+    int m_rowsWritten;
+    QString m_errorString;
+    StreamEncoder *m_encoder;
+
+    void abort(const QString &error);
+
+};
+
+#endif // IMAGESTREAMWRITER_H
@@ -0,0 +1,232 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "lodpolicy.h"
+
+#include <QImage>
+#include <QMutexLocker>
+
+// indexed by AbstractItemBase::RenderQuality: Balanced, Performance, Quality
+LodPolicy::Thresholds LodPolicy::m_thresholds[3] = {
+    {0.35, 0.2, 0.1, 1.0},
+    {0.6, 0.35, 0.2, 2.0},
+    {0.15, 0.08, 0.04, 0.5}
+};
+
+QHash<qint64, QRgb> LodPolicy::m_averageColors;
+QMutex LodPolicy::m_mutex;
+
+// edge length of the downscaled image the average color is computed from
+static const int AverageSampleSize = 32;
+
+// maximum number of cached average colors, keys of replaced pixmaps are never looked up again
+static const int AverageColorCacheSize = 256;
+
+/***************************************************
+ *
+ * Properties
+ *
+ ***************************************************/
+
+/*!
+ * \brief Returns the render tier for the given level of detail and render quality.
+ * \param lod level of detail of the paint call
+ * \param quality
+ * \return
+ */
+LodPolicy::Tier LodPolicy::tier(qreal lod, AbstractItemBase::RenderQuality quality)
+{
+    const Thresholds &t = m_thresholds[quality];
+
+    if(lod < t.thumbnail) return Tier::Thumbnail;
+    if(lod < t.minimal) return Tier::Minimal;
+    if(lod < t.reduced) return Tier::Reduced;
+
+    return Tier::Full;
+}
+
+
+LodPolicy::Thresholds LodPolicy::thresholds(AbstractItemBase::RenderQuality quality)
+{
+    return m_thresholds[quality];
+}
+
+
+void LodPolicy::setThresholds(AbstractItemBase::RenderQuality quality, const Thresholds &thresholds)
+{
+    m_thresholds[quality] = thresholds;
+}
+
+/***************************************************
+ *
+ * Members
+ *
+ ***************************************************/
+
+/*!
+ * \brief Returns false if the rect is smaller than the minimum size in device pixels in both dimensions.
+ * Only applies from the Minimal tier on, so items never disappear at moderate zoom levels.
+ * \param rect
+ * \param lod
+ * \param quality
+ * \return
+ */
+bool LodPolicy::isVisible(const QRectF &rect, qreal lod, AbstractItemBase::RenderQuality quality)
+{
+    if(tier(lod, quality) < Tier::Minimal) return true;
+
+    const qreal minimumSize = m_thresholds[quality].minimumSize;
+
+    return rect.width() * lod >= minimumSize || rect.height() * lod >= minimumSize;
+}
+
+/*!
+ * \brief Returns false for lines thinner than half of the minimum size in device pixels, e.g. strokes.
+ */
+bool LodPolicy::isVisible(qreal width, qreal lod, AbstractItemBase::RenderQuality quality)
+{
+    if(tier(lod, quality) < Tier::Minimal) return true;
+
+    return width * lod >= m_thresholds[quality].minimumSize / 2;
+}
+
+/*!
+ * \brief Returns a flat color version of the fill if the tier doesn't draw its kind anymore.
+ * Opacity is baked into the color, because color fills ignore it.
+ * \param fills
+ * \param tier
+ * \return
+ */
+Fills LodPolicy::simplified(const Fills &fills, Tier tier)
+{
+    if(tier < Tier::Reduced) return fills;
+
+    QColor color;
+
+    switch(fills.fillType()){
+    case FillType::Image:
+        color = averageColor(fills.pixmap());
+        break;
+    case FillType::LinearGradient:
+    case FillType::RadialGradient:
+    case FillType::ConicalGradient:
+        if(tier < Tier::Minimal) return fills;
+        color = averageColor(fills.gradient().stops());
+        break;
+    default:
+        return fills;
+    }
+
+    color.setAlphaF(color.alphaF() * fills.opacity());
+
+    Fills flat(fills);
+    flat.setColor(Color(color));
+
+    return flat;
+}
+
+/*!
+ * \brief Returns the color of a shadow drawn as flat rect. The blur spreads the color over twice the radius,
+ * so the alpha is reduced accordingly.
+ * \param shadow
+ * \return
+ */
+QColor LodPolicy::flatShadowColor(const Shadow &shadow)
+{
+    QColor color = shadow.color();
+    if(shadow.radius() > 0) color.setAlphaF(color.alphaF() / 2);
+
+    return color;
+}
+
+
+/*!
+ * \brief Returns the average color of a pixmap. Results of the last pixmaps are cached by the pixmap cache key.
+ * \param pixmap
+ * \return
+ */
+QColor LodPolicy::averageColor(const QPixmap &pixmap)
+{
+    if(pixmap.isNull()) return Qt::transparent;
+
+    QMutexLocker locker(&m_mutex);
+
+    if(m_averageColors.contains(pixmap.cacheKey())) return QColor::fromRgba(m_averageColors.value(pixmap.cacheKey()));
+
+    const QImage image = pixmap.toImage()
+            .scaled(AverageSampleSize, AverageSampleSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+            .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    // sum premultiplied values, so transparent pixels don't tint the result
+    quint64 r = 0, g = 0, b = 0, a = 0;
+
+    for(int y = 0; y < image.height(); ++y){
+        const QRgb *line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+        for(int x = 0; x < image.width(); ++x){
+            r += qRed(line[x]);
+            g += qGreen(line[x]);
+            b += qBlue(line[x]);
+            a += qAlpha(line[x]);
+        }
+    }
+
+    const quint64 count = static_cast<quint64>(image.width() * image.height());
+    const QRgb average = qUnpremultiply(qRgba(static_cast<int>(r / count),
+                                              static_cast<int>(g / count),
+                                              static_cast<int>(b / count),
+                                              static_cast<int>(a / count)));
+
+    if(m_averageColors.size() >= AverageColorCacheSize) m_averageColors.erase(m_averageColors.begin());
+    m_averageColors.insert(pixmap.cacheKey(), average);
+
+    return QColor::fromRgba(average);
+}
+
+
+/*!
+ * \brief Returns the average color of a gradient, weighting every stop interval by its length.
+ * \param stops
+ * \return
+ */
+QColor LodPolicy::averageColor(const QGradientStops &stops)
+{
+    if(stops.isEmpty()) return Qt::transparent;
+    if(stops.size() == 1) return stops.first().second;
+
+    qreal r = 0, g = 0, b = 0, a = 0, length = 0;
+
+    for(int i = 1; i < stops.size(); ++i){
+        const qreal weight = stops.at(i).first - stops.at(i - 1).first;
+        const QColor c0 = stops.at(i - 1).second;
+        const QColor c1 = stops.at(i).second;
+
+        r += weight * (c0.redF() + c1.redF()) / 2;
+        g += weight * (c0.greenF() + c1.greenF()) / 2;
+        b += weight * (c0.blueF() + c1.blueF()) / 2;
+        a += weight * (c0.alphaF() + c1.alphaF()) / 2;
+        length += weight;
+    }
+
+    if(length <= 0) return stops.first().second;
+
+    return QColor::fromRgbF(r / length, g / length, b / length, a / length);
+}
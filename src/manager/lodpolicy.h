@@ -0,0 +1,81 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef LODPOLICY_H
+#define LODPOLICY_H
+
+#include <QColor>
+#include <QGradient>
+#include <QHash>
+#include <QMutex>
+#include <QPixmap>
+#include <QRectF>
+
+#include <abstractitembase.h>
+#include <fills.h>
+#include <shadow.h>
+
+/*!
+ * \brief Maps the level of detail of a paint call onto simplified render tiers.
+ * Every RenderQuality has its own set of thresholds, so the quality setting of the view decides how early details are dropped.
+ * Export rendering (AbstractItemBase::render) always uses the Full tier.
+ */
+class LodPolicy
+{
+public:
+
+    enum Tier {
+        Full = 0,       // everything
+        Reduced = 1,    // flat shadows, no inner shadows, image fills as average color
+        Minimal = 2,    // additionally gradients as average color, no sub-pixel items and strokes
+        Thumbnail = 3   // artboards composite their snapshot, even while it is rebuilt
+    };
+
+    struct Thresholds {
+        qreal reduced;      // level of detail below which the Reduced tier starts
+        qreal minimal;
+        qreal thumbnail;
+        qreal minimumSize;  // smallest item size in device pixels that is drawn from Minimal on
+    };
+
+    static Tier tier(qreal lod, AbstractItemBase::RenderQuality quality);
+    static Thresholds thresholds(AbstractItemBase::RenderQuality quality);
+    static void setThresholds(AbstractItemBase::RenderQuality quality, const Thresholds &thresholds);
+
+    static bool isVisible(const QRectF &rect, qreal lod, AbstractItemBase::RenderQuality quality);
+    static bool isVisible(qreal width, qreal lod, AbstractItemBase::RenderQuality quality);
+
+    static Fills simplified(const Fills &fills, Tier tier);
+    static QColor flatShadowColor(const Shadow &shadow);
+
+    static QColor averageColor(const QPixmap &pixmap);
+    static QColor averageColor(const QGradientStops &stops);
+
+private:
+
+    static Thresholds m_thresholds[3];
+    static QHash<qint64, QRgb> m_averageColors;
+    static QMutex m_mutex;
+
+};
+
+#endif // LODPOLICY_H
@@ -30,8 +30,14 @@
 #include <QPointF>
 #include <QPainterPath>
 #include <QTransform>
+#include <QRectF>
+#include <QColor>
+#include <QPen>
+#include <QVector>
+#include <QList>
 
 #include <skia_includes.h>
+#include <SkColor.h>
 
 namespace skia{
 
@@ -49,6 +55,79 @@ SkPoint skPoint(const QPointF &point)
   return SkPoint::Make(SkFloatToScalar(point.x()), SkFloatToScalar(point.y()));
 }
 
+SkRect skRect(const QRectF &rect)
+{
+  return SkRect::MakeXYWH(SkFloatToScalar(rect.x()), SkFloatToScalar(rect.y()),
+                          SkFloatToScalar(rect.width()), SkFloatToScalar(rect.height()));
+}
+
+SkColor skColor(const QColor &color)
+{
+  return SkColorSetARGB(static_cast<U8CPU>(color.alpha()), static_cast<U8CPU>(color.red()),
+                        static_cast<U8CPU>(color.green()), static_cast<U8CPU>(color.blue()));
+}
+
+/*!
+ * \brief Sets stroke style, width, cap, join, miter limit and dash pattern of the pen. The brush is left untouched.
+ * \param paint
+ * \param pen
+ * \param width stroke width, replaces the pen width
+ */
+void skStroke(SkPaint &paint, const QPen &pen, qreal width)
+{
+  paint.setStyle(SkPaint::kStroke_Style);
+  paint.setStrokeWidth(SkFloatToScalar(width));
+  // Qt measures the miter from the join point, Skia across the full stroke width
+  paint.setStrokeMiter(SkFloatToScalar(pen.miterLimit() * 2));
+
+  switch(pen.capStyle())
+    {
+    case Qt::SquareCap:
+      paint.setStrokeCap(SkPaint::kSquare_Cap);
+      break;
+    case Qt::RoundCap:
+      paint.setStrokeCap(SkPaint::kRound_Cap);
+      break;
+    default:
+      paint.setStrokeCap(SkPaint::kButt_Cap);
+      break;
+    }
+
+  switch(pen.joinStyle())
+    {
+    case Qt::BevelJoin:
+      paint.setStrokeJoin(SkPaint::kBevel_Join);
+      break;
+    case Qt::RoundJoin:
+      paint.setStrokeJoin(SkPaint::kRound_Join);
+      break;
+    default:
+      paint.setStrokeJoin(SkPaint::kMiter_Join);
+      break;
+    }
+
+  if(pen.style() != Qt::SolidLine && pen.style() != Qt::NoPen)
+    {
+      // dash pattern is in units of the pen width
+      const qreal unit = qMax(width, 1.0);
+      QVector<qreal> pattern = pen.dashPattern();
+      if(pattern.size() % 2) pattern.append(pattern.last());
+
+      QVector<SkScalar> intervals;
+      intervals.reserve(pattern.size());
+      foreach(qreal dash, pattern)
+        {
+          intervals.append(SkFloatToScalar(qMax(dash * unit, 0.01)));
+        }
+
+      if(!intervals.isEmpty())
+        {
+          paint.setPathEffect(SkDashPathEffect::Make(intervals.constData(), intervals.size(),
+                                                     SkFloatToScalar(pen.dashOffset() * unit)));
+        }
+    }
+}
+
 int skFillRule(int rule)
 {
   switch(rule)
@@ -61,27 +140,70 @@ int skFillRule(int rule)
     }
 }
 
-SkPath skPath(const QPainterPath &qpath)
+// paths with fewer elements are converted faster than looked up
+static const int PathCacheThreshold = 32;
+static const int PathCacheSize = 32;
+
+struct PathCacheEntry {
+  QPainterPath source;
+  int elementCount;
+  QRectF controlRect;
+  SkPath path;
+};
+
+/*!
+ * \brief Most recently used conversions of the current thread, the front entry is the newest one.
+ * Entries keep their source path alive. Element count and control point rect are compared
+ * first, the element wise comparison only runs for paths that match both.
+ */
+static QList<PathCacheEntry> &pathCache()
+{
+  static thread_local QList<PathCacheEntry> cache;
+  return cache;
+}
+
+/*!
+ * \brief Converts all elements in one pass. Point storage is reserved up front and
+ * subpaths ending on their start point are closed.
+ */
+static SkPath convertPath(const QPainterPath &qpath)
 {
   SkPath path;
-  int count = qpath.elementCount();
+  const int count = qpath.elementCount();
+
+  path.incReserve(count);
+
+  int subpathStart = 0;
+
+  auto closeSubpath = [&](int last){
+      if(last - subpathStart < 2) return;
+      const QPainterPath::Element &first = qpath.elementAt(subpathStart);
+      const QPainterPath::Element &end = qpath.elementAt(last);
+      // Qt doesn't have any special definition if path is closed expect that it's first and last points are equal
+      if(are_equal(first.x, end.x) && are_equal(first.y, end.y)) path.close();
+  };
+
   for(int i = 0; i < count; i++)
     {
-      QPainterPath::Element elem = qpath.elementAt(i);
+      const QPainterPath::Element &elem = qpath.elementAt(i);
       switch(elem.type)
         {
         case QPainterPath::MoveToElement:
-          path.moveTo(skPoint(elem));
+          closeSubpath(i - 1);
+          subpathStart = i;
+          path.moveTo(SkFloatToScalar(elem.x), SkFloatToScalar(elem.y));
           break;
         case QPainterPath::LineToElement:
-          path.lineTo(skPoint(elem));
+          path.lineTo(SkFloatToScalar(elem.x), SkFloatToScalar(elem.y));
           break;
         case QPainterPath::CurveToElement:
           {
-            path.cubicTo(skPoint(elem),
-                         skPoint(qpath.elementAt(i+1)),
-                         skPoint(qpath.elementAt(i+2))
-                         );
+            const QPainterPath::Element &c2 = qpath.elementAt(i+1);
+            const QPainterPath::Element &end = qpath.elementAt(i+2);
+            path.cubicTo(SkFloatToScalar(elem.x), SkFloatToScalar(elem.y),
+                         SkFloatToScalar(c2.x), SkFloatToScalar(c2.y),
+                         SkFloatToScalar(end.x), SkFloatToScalar(end.y));
+            i += 2;
             break;
           }
         default:
@@ -94,18 +216,49 @@ SkPath skPath(const QPainterPath &qpath)
       path.lineTo( skPoint( qpath.elementAt(0) ));
       path.close();
     }
-
-  if(count > 3
-         && are_equal( qpath.elementAt(count - 1).x, qpath.elementAt(0).x )
-         && are_equal( qpath.elementAt(count - 1).y, qpath.elementAt(0).y )
-     )
-    path.close();
-  // Qt doesn't have any special definition if path is closed expect that it's first and last points are equal
+  else closeSubpath(count - 1);
 
   path.setFillType( (SkPathFillType)skFillRule( qpath.fillRule() ));
   return path;
 }
 
+SkPath skPath(const QPainterPath &qpath)
+{
+  if(qpath.elementCount() < PathCacheThreshold) return convertPath(qpath);
+
+  QList<PathCacheEntry> &cache = pathCache();
+  const int elementCount = qpath.elementCount();
+  const QRectF controlRect = qpath.controlPointRect();
+
+  for(int i = 0; i < cache.size(); ++i)
+    {
+      const PathCacheEntry &candidate = cache.at(i);
+      if(candidate.elementCount == elementCount &&
+         candidate.controlRect == controlRect &&
+         candidate.source == qpath)
+        {
+          if(i > 0) cache.move(i, 0);
+          return cache.first().path;
+        }
+    }
+
+  PathCacheEntry entry;
+  entry.source = qpath;
+  entry.elementCount = elementCount;
+  entry.controlRect = controlRect;
+  entry.path = convertPath(qpath);
+
+  cache.prepend(entry);
+  if(cache.size() > PathCacheSize) cache.removeLast();
+
+  return entry.path;
+}
+
+void clearPathCache()
+{
+  pathCache().clear();
+}
+
 
 
 };
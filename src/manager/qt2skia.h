@@ -26,20 +26,34 @@
 #ifndef QT2SKIA_H
 #define QT2SKIA_H
 
+#include <cstdint>
+
+#include <QtGlobal>
+
+typedef uint32_t SkColor;
 
 struct SkPoint;
+struct SkRect;
 class SkPath;
 class SkMatrix;
+class SkPaint;
 
 class QPointF;
+class QRectF;
+class QColor;
 class QPainterPath;
 class QTransform;
+class QPen;
 
 namespace skia{
 
     SkMatrix skMatrix (const QTransform &tr);
     SkPoint skPoint (const QPointF &point);
+    SkRect skRect (const QRectF &rect);
+    SkColor skColor (const QColor &color);
+    void skStroke (SkPaint &paint, const QPen &pen, qreal width);
     SkPath skPath (const QPainterPath &qpath);
+    void clearPathCache ();
     int skFillRule (int rule);
 };
 
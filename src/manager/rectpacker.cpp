@@ -0,0 +1,218 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "rectpacker.h"
+
+#include <algorithm>
+#include <climits>
+
+/***************************************************
+ *
+ * Constructor
+ *
+ ***************************************************/
+
+RectPacker::RectPacker(const QSize &size)
+{
+    m_size = size;
+    m_freeRects.append(QRect(QPoint(0, 0), size));
+}
+
+/***************************************************
+ *
+ * Properties
+ *
+ ***************************************************/
+
+QSize RectPacker::size() const
+{
+    return m_size;
+}
+
+/*!
+ * \brief Returns the size of the area covered by placed rectangles, measured from the origin.
+ * \return
+ */
+QSize RectPacker::usedSize() const
+{
+    return QSize(m_usedRect.right() + 1, m_usedRect.bottom() + 1);
+}
+
+/***************************************************
+ *
+ * Members
+ *
+ ***************************************************/
+
+/*!
+ * \brief Places a rectangle into the free rectangle that leaves the shortest side over.
+ * \param size
+ * \param position top left corner of the placed rectangle
+ * \return false if the rectangle doesn't fit anymore
+ */
+bool RectPacker::insert(const QSize &size, QPoint &position)
+{
+    if(size.isEmpty()) return false;
+
+    int bestShortSide = INT_MAX;
+    int bestLongSide = INT_MAX;
+    QRect best;
+
+    foreach(const QRect &free, m_freeRects){
+
+        if(free.width() < size.width() || free.height() < size.height()) continue;
+
+        const int leftoverX = free.width() - size.width();
+        const int leftoverY = free.height() - size.height();
+        const int shortSide = qMin(leftoverX, leftoverY);
+        const int longSide = qMax(leftoverX, leftoverY);
+
+        if(shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)){
+            best = QRect(free.topLeft(), size);
+            bestShortSide = shortSide;
+            bestLongSide = longSide;
+        }
+    }
+
+    if(best.isNull()) return false;
+
+    splitFreeRects(best);
+    pruneFreeRects();
+
+    m_usedRect = m_usedRect.united(best);
+    position = best.topLeft();
+
+    return true;
+}
+
+/*!
+ * \brief Packs rectangles into as many pages as needed. Rectangles are placed in order of decreasing height,
+ * rectangles larger than a page get a page of their own. Empty sizes aren't placed and keep page -1.
+ * \param sizes
+ * \param pageSize
+ * \param padding space kept free to the right and below of every rectangle
+ * \return placement for every size, in order of the input
+ */
+QList<RectPacker::Placement> RectPacker::pack(const QList<QSize> &sizes, const QSize &pageSize, int padding)
+{
+    QList<Placement> placements;
+    placements.reserve(sizes.count());
+
+    QList<int> order;
+    for(int i = 0; i < sizes.count(); ++i){
+        placements.append(Placement());
+        order.append(i);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&sizes](int a, int b){
+        if(sizes[a].height() != sizes[b].height()) return sizes[a].height() > sizes[b].height();
+        return sizes[a].width() > sizes[b].width();
+    });
+
+    QList<RectPacker> pages;
+
+    foreach(int index, order){
+
+        if(sizes[index].isEmpty()) continue;
+
+        const QSize size = sizes[index] + QSize(padding, padding);
+        QPoint position;
+        int page = -1;
+
+        for(int p = 0; p < pages.count(); ++p){
+            if(pages[p].insert(size, position)){
+                page = p;
+                break;
+            }
+        }
+
+        if(page < 0){
+            pages.append(RectPacker(size.expandedTo(pageSize)));
+            page = pages.count() - 1;
+            pages[page].insert(size, position);
+        }
+
+        placements[index].page = page;
+        placements[index].rect = QRect(position, sizes[index]);
+    }
+
+    return placements;
+}
+
+/***************************************************
+ *
+ * Private
+ *
+ ***************************************************/
+
+/*!
+ * \brief Splits every free rectangle overlapping the placed one into up to four maximal rectangles around it.
+ */
+void RectPacker::splitFreeRects(const QRect &placed)
+{
+    QList<QRect> freeRects;
+
+    foreach(const QRect &free, m_freeRects){
+
+        if(!free.intersects(placed)){
+            freeRects.append(free);
+            continue;
+        }
+
+        if(placed.left() > free.left()){
+            freeRects.append(QRect(free.left(), free.top(), placed.left() - free.left(), free.height()));
+        }
+        if(placed.right() < free.right()){
+            freeRects.append(QRect(placed.right() + 1, free.top(), free.right() - placed.right(), free.height()));
+        }
+        if(placed.top() > free.top()){
+            freeRects.append(QRect(free.left(), free.top(), free.width(), placed.top() - free.top()));
+        }
+        if(placed.bottom() < free.bottom()){
+            freeRects.append(QRect(free.left(), placed.bottom() + 1, free.width(), free.bottom() - placed.bottom()));
+        }
+    }
+
+    m_freeRects = freeRects;
+}
+
+/*!
+ * \brief Removes free rectangles that are contained in another one.
+ */
+void RectPacker::pruneFreeRects()
+{
+    for(int i = 0; i < m_freeRects.count(); ++i){
+        for(int j = i + 1; j < m_freeRects.count(); ++j){
+
+            if(m_freeRects[j].contains(m_freeRects[i])){
+                m_freeRects.removeAt(i);
+                --i;
+                break;
+            }
+
+            if(m_freeRects[i].contains(m_freeRects[j])){
+                m_freeRects.removeAt(j);
+                --j;
+            }
+        }
+    }
+}
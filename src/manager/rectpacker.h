@@ -0,0 +1,64 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef RECTPACKER_H
+#define RECTPACKER_H
+
+#include <QList>
+#include <QRect>
+#include <QSize>
+
+/*!
+ * \brief MaxRects bin packer with best short side fit. Places rectangles without rotation into one page
+ * and keeps track of all maximal free rectangles left over.
+ */
+class RectPacker
+{
+public:
+
+    // position of one packed rectangle
+    struct Placement {
+        int page = -1;
+        QRect rect;
+    };
+
+    RectPacker(const QSize &size);
+
+    bool insert(const QSize &size, QPoint &position);
+
+    QSize size() const;
+    QSize usedSize() const;
+
+    static QList<Placement> pack(const QList<QSize> &sizes, const QSize &pageSize, int padding = 0);
+
+private:
+
+    QSize m_size;
+    QRect m_usedRect;
+    QList<QRect> m_freeRects;
+
+    void splitFreeRects(const QRect &placed);
+    void pruneFreeRects();
+
+};
+
+#endif // RECTPACKER_H
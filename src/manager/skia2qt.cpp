@@ -64,47 +64,49 @@ QPointF qtPoint (const SkPoint &skpoint)
     return QPointF(skpoint.x(), skpoint.y());
 }
 
+/*!
+ * \brief Converts all verbs in one pass with SkPath::Iter. Element storage is reserved up front,
+ * conics are approximated by quads.
+ */
 QPainterPath qtPath(const SkPath &skpath)
 {
     QPainterPath path;
-    int max = skpath.countVerbs();
-    uint8_t verbs[max];
-    skpath.getVerbs(verbs, max);
+    // cubics and converted conics need up to 3 elements per point
+    path.reserve(skpath.countPoints() * 2 + skpath.countVerbs());
 
-    int count = 0;
+    SkPath::Iter iter(skpath, false);
+    SkPoint pts[4];
+    SkPath::Verb verb;
 
-    for (int i = 0; i < max; ++i) {
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
 
-        switch( verbs[i] ){
-        case 0: // move
-            path.moveTo(qtPoint(skpath.getPoint(count)));
-            count +=1;
+        switch( verb ){
+        case SkPath::kMove_Verb:
+            path.moveTo(pts[0].x(), pts[0].y());
             break;
-        case 1: // line
-            path.lineTo(qtPoint(skpath.getPoint(count)));
-            count +=1;
+        case SkPath::kLine_Verb:
+            path.lineTo(pts[1].x(), pts[1].y());
             break;
-        case 2: // quad
-            path.quadTo(
-                        qtPoint(skpath.getPoint(count)),
-                        qtPoint(skpath.getPoint(count+1))
-                        );
-            count +=2;
+        case SkPath::kQuad_Verb:
+            path.quadTo(pts[1].x(), pts[1].y(), pts[2].x(), pts[2].y());
             break;
-        case 3: // conic
-            qDebug() << "conicTo";
-            count +=3;
+        case SkPath::kConic_Verb:{
+            // 2^2 quads are visually exact for the arcs path ops produce
+            const int pow2 = 2;
+            SkPoint quads[1 + 2 * (1 << pow2)];
+            int count = SkPath::ConvertConicToQuads(pts[0], pts[1], pts[2], iter.conicWeight(), quads, pow2);
+            for (int i = 0; i < count; ++i) {
+                path.quadTo(quads[i * 2 + 1].x(), quads[i * 2 + 1].y(), quads[i * 2 + 2].x(), quads[i * 2 + 2].y());
+            }
             break;
-        case 4: // cubic
-            path.cubicTo(
-                        qtPoint(skpath.getPoint(count)),
-                        qtPoint(skpath.getPoint(count+1)),
-                        qtPoint(skpath.getPoint(count+2))
-                        );
-            count +=3;
+        }
+        case SkPath::kCubic_Verb:
+            path.cubicTo(pts[1].x(), pts[1].y(), pts[2].x(), pts[2].y(), pts[3].x(), pts[3].y());
+            break;
+        case SkPath::kClose_Verb:
+            path.closeSubpath();
             break;
-        case 5: // close
-        case 6: // done
+        default:
             break;
         }
     }
@@ -0,0 +1,344 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#include "skiarenderer.h"
+#include <qt2skia.h>
+
+#include <QPen>
+#include <QBrush>
+#include <QGradient>
+#include <QPaintEngine>
+#include <QVector>
+#include <QtMath>
+
+#include <SkCanvas.h>
+#include <SkSurface.h>
+#include <SkPaint.h>
+#include <SkShader.h>
+#include <SkImage.h>
+#include <SkImageInfo.h>
+#include <SkPixmap.h>
+#include <SkGradientShader.h>
+#include <SkDashPathEffect.h>
+
+// Skia color type with the same memory layout as QImage::Format_ARGB32_Premultiplied
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+static const QImage::Format ImageFormat = QImage::Format_ARGB32_Premultiplied;
+static const SkColorType ColorType = kBGRA_8888_SkColorType;
+#else
+static const QImage::Format ImageFormat = QImage::Format_RGBA8888_Premultiplied;
+static const SkColorType ColorType = kRGBA_8888_SkColorType;
+#endif
+
+SkiaRenderer::Backend SkiaRenderer::m_backend = SkiaRenderer::QPainterBackend;
+
+/***************************************************
+ *
+ * Constructor
+ *
+ ***************************************************/
+
+SkiaRenderer::SkiaRenderer(QImage &image)
+{
+    if(image.format() != ImageFormat) image = image.convertToFormat(ImageFormat);
+
+    SkImageInfo info = SkImageInfo::Make(image.width(), image.height(), ColorType, kPremul_SkAlphaType);
+    m_surface = SkSurface::MakeRasterDirect(info, image.bits(), static_cast<size_t>(image.bytesPerLine()));
+}
+
+SkiaRenderer::~SkiaRenderer()
+{
+}
+
+/***************************************************
+ *
+ * Properties
+ *
+ ***************************************************/
+
+bool SkiaRenderer::isValid() const
+{
+    return m_surface != nullptr;
+}
+
+SkCanvas *SkiaRenderer::canvas() const
+{
+    return (m_surface) ? m_surface->getCanvas() : nullptr;
+}
+
+SkiaRenderer::Backend SkiaRenderer::backend()
+{
+    return m_backend;
+}
+
+/*!
+ * \brief Selects the backend items use in paint(). Can be switched at runtime.
+ * \param backend
+ */
+void SkiaRenderer::setBackend(SkiaRenderer::Backend backend)
+{
+    m_backend = backend;
+}
+
+/***************************************************
+ *
+ * Members
+ *
+ ***************************************************/
+
+/*!
+ * \brief Returns true if the Skia backend is active and the painter draws into pixels, like a widget or a QImage.
+ * Recording and vector devices keep the QPainter commands, so exports stay vector and rasterization can run later.
+ * \param painter
+ * \return
+ */
+bool SkiaRenderer::isTarget(QPainter *painter)
+{
+    return m_backend == SkiaBackend && painter->paintEngine() && painter->paintEngine()->type() == QPaintEngine::Raster;
+}
+
+
+/*!
+ * \brief Rasterizes the visible part of rect with Skia and draws the result with the painter.
+ * The canvas uses the full device transform of the painter, so the layer is drawn 1:1 in device pixels,
+ * including the device pixel ratio of HiDPI devices.
+ * Blend modes apply against the transparent layer and not against the content below it.
+ * \param painter
+ * \param rect area in painter coordinates which has to contain all drawing
+ * \param draw
+ * \return false if no raster surface could be created
+ */
+bool SkiaRenderer::render(QPainter *painter, const QRectF &rect, const std::function<void (SkCanvas *)> &draw)
+{
+    // the device transform contains the device pixel ratio, device sizes are logical
+    const QTransform transform = painter->deviceTransform();
+    const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+
+    QRect deviceRect = transform.mapRect(rect).toAlignedRect();
+
+    if(painter->device()){
+        deviceRect &= QRect(0, 0, qCeil(painter->device()->width() * dpr), qCeil(painter->device()->height() * dpr));
+    }
+
+    if(painter->hasClipping()){
+        deviceRect &= transform.mapRect(painter->clipBoundingRect()).toAlignedRect();
+    }
+
+    if(deviceRect.isEmpty()) return true;
+
+    QImage layer(deviceRect.size(), ImageFormat);
+    layer.fill(Qt::transparent);
+    layer.setDevicePixelRatio(dpr);
+
+    {
+        SkiaRenderer renderer(layer);
+        if(!renderer.isValid()) return false;
+
+        SkCanvas *canvas = renderer.canvas();
+        canvas->translate(-deviceRect.x(), -deviceRect.y());
+        canvas->concat(skia::skMatrix(transform));
+
+        draw(canvas);
+    }
+
+    painter->save();
+    painter->setWorldTransform(QTransform());
+    painter->setViewTransformEnabled(false);
+    painter->setCompositionMode(QPainter::CompositionMode_SourceOver);
+    // resetting the world transform keeps the scale of the device pixel ratio
+    painter->drawImage(QPointF(deviceRect.topLeft()) / dpr, layer);
+    painter->restore();
+
+    return true;
+}
+
+
+/*!
+ * \brief Applies color or shader of a brush to a fill paint.
+ * \param paint
+ * \param brush
+ * \return false if the brush doesn't draw anything
+ */
+bool SkiaRenderer::setBrush(SkPaint &paint, const QBrush &brush)
+{
+    paint.setColor(skia::skColor(brush.color()));
+
+    switch(brush.style()){
+    case Qt::NoBrush:
+        return false;
+    case Qt::LinearGradientPattern:
+    case Qt::RadialGradientPattern:
+    case Qt::ConicalGradientPattern:{
+        sk_sp<SkShader> gradient = shader(*brush.gradient());
+        if(!gradient) return false;
+        paint.setColor(SK_ColorBLACK);
+        paint.setShader(gradient->makeWithLocalMatrix(skia::skMatrix(brush.transform())));
+        break;
+    }
+    case Qt::TexturePattern:{
+        sk_sp<SkImage> texture = image(brush.textureImage());
+        if(!texture) return false;
+        SkMatrix matrix = skia::skMatrix(brush.transform());
+        paint.setColor(SK_ColorBLACK);
+        paint.setShader(texture->makeShader(SkTileMode::kRepeat, SkTileMode::kRepeat, &matrix));
+        break;
+    }
+    default:
+        break;
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief Converts a pen to stroke settings of a paint.
+ * \param paint
+ * \param pen
+ * \return false if the pen doesn't draw anything
+ */
+bool SkiaRenderer::setPen(SkPaint &paint, const QPen &pen)
+{
+    if(pen.style() == Qt::NoPen || !setBrush(paint, pen.brush())) return false;
+
+    skia::skStroke(paint, pen, pen.widthF());
+
+    return true;
+}
+
+
+/*!
+ * \brief Creates the Skia equivalent of a linear, radial or conical QGradient.
+ * \param gradient
+ * \return
+ */
+sk_sp<SkShader> SkiaRenderer::shader(const QGradient &gradient)
+{
+    const QGradientStops stops = gradient.stops();
+
+    QVector<SkColor> colors;
+    QVector<SkScalar> positions;
+    colors.reserve(stops.size());
+    positions.reserve(stops.size());
+
+    foreach(QGradientStop stop, stops){
+        colors.append(skia::skColor(stop.second));
+        positions.append(SkFloatToScalar(stop.first));
+    }
+
+    if(colors.isEmpty()) return SkShaders::Color(SK_ColorTRANSPARENT);
+    if(colors.size() == 1) return SkShaders::Color(colors.first());
+
+    SkTileMode mode;
+    switch(gradient.spread()){
+    case QGradient::ReflectSpread:
+        mode = SkTileMode::kMirror;
+        break;
+    case QGradient::RepeatSpread:
+        mode = SkTileMode::kRepeat;
+        break;
+    default:
+        mode = SkTileMode::kClamp;
+        break;
+    }
+
+    switch(gradient.type()){
+    case QGradient::LinearGradient:{
+        const QLinearGradient &linear = static_cast<const QLinearGradient&>(gradient);
+        SkPoint points[2] = { skia::skPoint(linear.start()), skia::skPoint(linear.finalStop()) };
+        return SkGradientShader::MakeLinear(points, colors.constData(), positions.constData(), colors.size(), mode);
+    }
+    case QGradient::RadialGradient:{
+        const QRadialGradient &radial = static_cast<const QRadialGradient&>(gradient);
+
+        if(radial.focalPoint() == radial.center() && qFuzzyIsNull(radial.focalRadius())){
+            return SkGradientShader::MakeRadial(skia::skPoint(radial.center()), SkFloatToScalar(radial.radius()),
+                                                colors.constData(), positions.constData(), colors.size(), mode);
+        }
+
+        return SkGradientShader::MakeTwoPointConical(skia::skPoint(radial.focalPoint()), SkFloatToScalar(radial.focalRadius()),
+                                                     skia::skPoint(radial.center()), SkFloatToScalar(radial.radius()),
+                                                     colors.constData(), positions.constData(), colors.size(), mode);
+    }
+    case QGradient::ConicalGradient:{
+        const QConicalGradient &conical = static_cast<const QConicalGradient&>(gradient);
+
+        // Qt runs counter-clockwise from angle, Skia sweeps clockwise from 3 o'clock
+        SkMatrix matrix;
+        matrix.setRotate(SkFloatToScalar(conical.angle()));
+        matrix.postScale(1, -1);
+        matrix.postTranslate(SkFloatToScalar(conical.center().x()), SkFloatToScalar(conical.center().y()));
+
+        return SkGradientShader::MakeSweep(0, 0, colors.constData(), positions.constData(), colors.size(),
+                                           SkTileMode::kClamp, 0, 360, 0, &matrix);
+    }
+    default:
+        return SkShaders::Color(colors.first());
+    }
+}
+
+
+/*!
+ * \brief Creates a raster image with a copy of the pixels.
+ * \param image
+ * \return
+ */
+sk_sp<SkImage> SkiaRenderer::image(const QImage &image)
+{
+    const QImage source = (image.format() == ImageFormat) ? image : image.convertToFormat(ImageFormat);
+
+    SkImageInfo info = SkImageInfo::Make(source.width(), source.height(), ColorType, kPremul_SkAlphaType);
+    SkPixmap pixmap(info, source.constBits(), static_cast<size_t>(source.bytesPerLine()));
+
+    return SkImage::MakeRasterCopy(pixmap);
+}
+
+
+SkBlendMode SkiaRenderer::blendMode(QPainter::CompositionMode mode)
+{
+    switch(mode){
+    case QPainter::CompositionMode_DestinationOver: return SkBlendMode::kDstOver;
+    case QPainter::CompositionMode_Clear: return SkBlendMode::kClear;
+    case QPainter::CompositionMode_Source: return SkBlendMode::kSrc;
+    case QPainter::CompositionMode_Destination: return SkBlendMode::kDst;
+    case QPainter::CompositionMode_SourceIn: return SkBlendMode::kSrcIn;
+    case QPainter::CompositionMode_DestinationIn: return SkBlendMode::kDstIn;
+    case QPainter::CompositionMode_SourceOut: return SkBlendMode::kSrcOut;
+    case QPainter::CompositionMode_DestinationOut: return SkBlendMode::kDstOut;
+    case QPainter::CompositionMode_SourceAtop: return SkBlendMode::kSrcATop;
+    case QPainter::CompositionMode_DestinationAtop: return SkBlendMode::kDstATop;
+    case QPainter::CompositionMode_Xor: return SkBlendMode::kXor;
+    case QPainter::CompositionMode_Plus: return SkBlendMode::kPlus;
+    case QPainter::CompositionMode_Multiply: return SkBlendMode::kMultiply;
+    case QPainter::CompositionMode_Screen: return SkBlendMode::kScreen;
+    case QPainter::CompositionMode_Overlay: return SkBlendMode::kOverlay;
+    case QPainter::CompositionMode_Darken: return SkBlendMode::kDarken;
+    case QPainter::CompositionMode_Lighten: return SkBlendMode::kLighten;
+    case QPainter::CompositionMode_ColorDodge: return SkBlendMode::kColorDodge;
+    case QPainter::CompositionMode_ColorBurn: return SkBlendMode::kColorBurn;
+    case QPainter::CompositionMode_HardLight: return SkBlendMode::kHardLight;
+    case QPainter::CompositionMode_SoftLight: return SkBlendMode::kSoftLight;
+    case QPainter::CompositionMode_Difference: return SkBlendMode::kDifference;
+    case QPainter::CompositionMode_Exclusion: return SkBlendMode::kExclusion;
+    default: return SkBlendMode::kSrcOver;
+    }
+}
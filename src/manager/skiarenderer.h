@@ -0,0 +1,78 @@
+/*************************************************************************************
+
+   Draftoola - UI and UX prototyping tool for designing static and animated layouts.
+
+   Copyright (C) 2020 Martin Reininger <nitramr>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+**************************************************************************************/
+
+#ifndef SKIARENDERER_H
+#define SKIARENDERER_H
+
+#include <QImage>
+#include <QPainter>
+#include <functional>
+
+#include <SkRefCnt.h>
+#include <SkBlendMode.h>
+
+class SkCanvas;
+class SkSurface;
+class SkShader;
+class SkImage;
+class SkPaint;
+
+/*!
+ * \brief Skia raster backend. Wraps the pixel buffer of a QImage into a SkSurface, so everything drawn to canvas()
+ * is available in the QImage without copying.
+ */
+class SkiaRenderer
+{
+public:
+
+    enum Backend {
+        QPainterBackend = 0,
+        SkiaBackend = 1
+    };
+
+    SkiaRenderer(QImage &image);
+    ~SkiaRenderer();
+
+    bool isValid() const;
+    SkCanvas *canvas() const;
+
+    static Backend backend();
+    static void setBackend(Backend backend);
+
+    static bool isTarget(QPainter *painter);
+    static bool render(QPainter *painter, const QRectF &rect, const std::function<void(SkCanvas*)> &draw);
+
+    static bool setBrush(SkPaint &paint, const QBrush &brush);
+    static bool setPen(SkPaint &paint, const QPen &pen);
+    static sk_sp<SkShader> shader(const QGradient &gradient);
+    static sk_sp<SkImage> image(const QImage &image);
+    static SkBlendMode blendMode(QPainter::CompositionMode mode);
+
+private:
+
+    sk_sp<SkSurface> m_surface;
+
+    static Backend m_backend;
+
+};
+
+#endif // SKIARENDERER_H